@@ -0,0 +1,61 @@
+#pragma once
+#include "library.hpp"
+#include "Command.hpp"
+/**
+ * The header file for the AutonAnalyzer namespace, which runs every autonomous routine
+ * with the Timeline simulating (see Timeline.hpp), so nothing moves, and reports how long
+ * each routine takes, when each step starts and ends, and which waits leave the robot
+ * sitting still. The report is printed to the terminal and saved to the microSD card as
+ * JSON, one routine per line, so it can be compared from one version of the code to the next.
+ *
+ * The times are estimates from the simple drivetrain model in Timeline.hpp, so they are
+ * best used to compare routines and find where time goes, rather than as exact times.
+ * The same report is written for the real routine at the end of every autonomous().
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+namespace AutonAnalyzer
+{
+    /**
+     * The file the report is saved to
+     */
+    constexpr const char * reportPath = "/usd/auton_report.json";
+    /**
+     * Returns the name of a routine, as used in the report
+     */
+    const char * getName(Auton id);
+    /**
+     * Simulates every routine except replay (which is a recording, not a command graph)
+     * and writes the report. Nothing on the robot moves, and it takes well under a second.
+     * It reuses the CommandPool, so the caller must hold the lock (see tryLock())
+     * @return The simulated time of the longest routine, in milliseconds
+     */
+    uint32_t analyzeAll();
+    /**
+     * Simulates one routine. Like analyzeAll, the caller must hold the lock
+     * @param id The routine to simulate
+     * @param writeReport Whether to write the routine's report
+     * @return The simulated time of the routine, in milliseconds
+     */
+    uint32_t simulate(Auton id, bool writeReport = false);
+    /**
+     * Writes the report for whatever is currently in the Timeline, to the terminal and,
+     * if a microSD card is in, to the end of the report file
+     * @param id The routine the Timeline holds
+     */
+    void report(Auton id);
+    /**
+     * The CommandPool, the Timeline's simulation and the scheduler simulate() runs on are
+     * shared by everything that builds or simulates a routine: PreArm, autonomous(), and
+     * the GUI's Analyze button and autonomous. Each of them holds this lock while it uses
+     * them, so one can't reset the pool under another.
+     * tryLock() takes it if it is free and returns whether it did, lock() waits for it,
+     * and unlock() frees it. The lock isn't tied to a task, so whoever ends a task that
+     * holds it has to free it (see PreArm::recover())
+     */
+    bool tryLock();
+    void lock();
+    void unlock();
+}
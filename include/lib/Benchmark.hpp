@@ -0,0 +1,82 @@
+#pragma once
+#include "api.h"
+/**
+ * The header file for the Benchmark namespace, which times the code that runs most often
+ * (the drive PID, planning one driver control tick, one PoseEKF update, planning a
+ * Trajectory, and updating a telemetry label) and counts how many heap allocations each one makes, so
+ * changes meant to speed them up can be measured instead of guessed.
+ *
+ * Each benchmark is run many times in a row on the brain and reported in nanoseconds and
+ * allocations per run. The first full run is saved to the microSD card as the baseline,
+ * and later runs are compared against it: a benchmark fails if it gets more than
+ * threshold percent slower, or makes more allocations than it used to. Delete the
+ * baseline file to save a new one.
+ *
+ * Allocations are counted by replacing the global operator new, so only C++ allocations
+ * (new, std::vector and so on) are counted. malloc calls from C code, and LVGL, which
+ * allocates from the kernel's heap, are not.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+namespace Benchmark
+{
+    /**
+     * The result of one benchmark: its name, how many times it ran, and the time
+     * and heap allocations per run
+     */
+    struct Result
+    {
+        const char * name;
+        uint32_t iterations;
+        double nsPerOp;
+        double allocsPerOp;
+    };
+    /**
+     * The file the baseline results are saved to
+     */
+    constexpr const char * baselinePath = "/usd/bench_baseline.txt";
+    /**
+     * How much slower than the baseline, in percent, a benchmark can get before it fails
+     */
+    constexpr double threshold = 10;
+    /**
+     * The most results that can be stored
+     */
+    constexpr int maxResults = 8;
+    /**
+     * Times a single call of a function that can't be run more than once, like
+     * GUI::initialize(), and stores the result so runAll() reports it
+     * @param name The name of the benchmark
+     * @param fn The function to time
+     */
+    void measureOnce(const char * name, void (*fn)());
+    /**
+     * Runs every benchmark, prints the results, and compares them to the baseline.
+     * The drive and driver control benchmarks set the motors to 0, so this should
+     * only be run while the robot is disabled or not being driven
+     * @return The number of benchmarks that failed
+     */
+    int runAll();
+    /**
+     * Returns the number of C++ heap allocations made since the program started
+     */
+    uint32_t allocations();
+    /**
+     * Drives the robot forward and back again once in each MoveMode (see library.hpp),
+     * and prints how long each move took to settle and how far from its target it
+     * stopped, so the brain's PID and the motors' own controllers can be compared.
+     * Unlike runAll(), this moves the robot, so it needs a clear space in front of it
+     * @param distance How far to drive each way, in inches
+     */
+    void compareMoveModes(double distance = 24);
+    /**
+     * Runs the Localizer (see Localizer.hpp) on a made up 60 second run around the field,
+     * with odometry that drifts and noisy Distance sensor readings, once for each particle
+     * count, and prints the average and final position error and the time per step next
+     * to the odometry's own error. Nothing is read from the hardware, so it can be run
+     * anywhere the Localizer compiles
+     */
+    void compareParticleCounts();
+}
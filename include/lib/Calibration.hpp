@@ -0,0 +1,66 @@
+#pragma once
+#include "api.h"
+/**
+ * The header file for the Calibration namespace, which measures the drivetrain's effective
+ * wheel diameter and track width on the robot, so the moves and the odometry use what the
+ * wheels actually do rather than what the ruler says.
+ *
+ * The effective wheel diameter is measured by pushing the robot straight along the field
+ * for straightDistance inches (two tiles, lined up on the seams): the encoders give the
+ * degrees the motors turned over a known distance, which includes any gearing and the
+ * wheels sinking into the tiles.
+ *
+ * The track width is measured by spinning the robot on the spot for a few full turns: the
+ * IMU gives the angle it turned, and the encoders (with the diameter above) give the inches
+ * each side rolled. As the wheels scrub sideways in a turn, this is usually wider than the
+ * distance between the wheels.
+ *
+ * Both are saved to the microSD card and loaded into the TankDrive at startup, so the
+ * robot only has to be calibrated again when the drivetrain changes.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+namespace Calibration
+{
+    //The file the geometry is saved to on the microSD card
+    constexpr const char * path = "/usd/drive_geometry.txt";
+    //The distance the robot is pushed to measure the wheel diameter, in inches
+    constexpr double straightDistance = 48;
+    //The number of full turns spun to measure the track width
+    constexpr int turns = 3;
+    //The longest the turns may take before the measurement is given up, in milliseconds
+    constexpr uint32_t turnTimeout = 15000;
+
+    /**
+     * Loads the saved geometry into the drive, if there is any
+     * @return true if a saved geometry was loaded
+     */
+    bool load();
+    /**
+     * Saves the drive's current geometry to the microSD card
+     * @return true if it was saved
+     */
+    bool save();
+    /**
+     * Records the drive's positions at the start of the straight measurement. The robot
+     * is then pushed straight forward straightDistance inches, and finishStraight called
+     */
+    void startStraight();
+    /**
+     * Works out the effective wheel diameter from how far the drive turned since
+     * startStraight, and gives it to the drive. The result is only saved by calibrateTurn,
+     * as the track width depends on it
+     * @return the new diameter, in inches, or 0 if the robot wasn't pushed far enough to measure
+     */
+    double finishStraight();
+    /**
+     * Spins the robot on the spot and works out the effective track width, then gives it to
+     * the drive and saves the geometry. It waits until the robot has finished turning, and
+     * pauses driver control while it runs. The IMU must be calibrated, and the caller must
+     * hold the claim on the robot (see Tasks.hpp), so nothing else drives it meanwhile
+     * @return the new track width, in inches, or 0 if it couldn't be measured
+     */
+    double calibrateTurn();
+}
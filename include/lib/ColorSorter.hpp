@@ -0,0 +1,152 @@
+#pragma once
+#include "api.h"
+#include "library.hpp"
+#include "Tasks.hpp"
+#include "Indexer.hpp"
+#include <atomic>
+/**
+ * The header file for the ColorSorter class, which uses a V5 Optical Sensor at the bottom
+ * of the conveyor to find balls of the opponent's color and throw them back out.
+ *
+ * The sensor is sampled in its own task with its LED at full brightness. A hue reading is
+ * only trusted while the proximity reading says a ball is right in front of the sensor, so
+ * the field tiles and other robots can't trigger an eject. The time each ball takes to pass
+ * the sensor gives the conveyor's ball speed, which is used to time the eject. Balls move
+ * up the conveyor away from the sensor, so the Indexer reverses once the ball has climbed
+ * ejectDistance above the sensor, and runs backwards long enough to carry it back down
+ * past the sensor and out of the bottom of the conveyor.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class ColorSorter
+{
+    private:
+        /**
+         * The Indexer used to eject balls
+         */
+        Indexer & indexer;
+        /**
+         * The port of the Optical Sensor
+         */
+        uint8_t port;
+        /**
+         * The color of ball to throw out. BallColor::none turns sorting off
+         */
+        std::atomic<BallColor> rejectColor;
+        /**
+         * The proximity reading (0 to 255) above which a ball is considered
+         * to be in front of the sensor
+         */
+        int proximityGate;
+        /**
+         * The distance, in inches, a ball climbs above the sensor before the conveyor
+         * is run backwards to throw it out
+         */
+        double ejectDistance;
+        /**
+         * The estimated speed of balls moving past the sensor, in inches per
+         * second. Updated after every ball that passed the sensor with the conveyor
+         * running up the whole time, from how long it blocked the sensor
+         */
+        double ballSpeed;
+        //Whether the conveyor has been running up the whole time the current ball has been at the sensor
+        bool carried;
+        /**
+         * The color of the ball currently in front of the sensor, and when, in microseconds,
+         * it arrived and was classified
+         */
+        BallColor currentBall;
+        uint64_t arriveTime, detectTime;
+        /**
+         * When, in milliseconds, the next eject should be sent to the indexer (0 if none
+         * is scheduled), how long the sorter planned to wait for the ball, and the
+         * classification time, in microseconds, of the last eject sent
+         */
+        uint32_t ejectAt, plannedWait;
+        uint64_t ejectSent;
+        /**
+         * The counts of balls seen and rejected, and the detect-to-actuate
+         * latency statistics, in microseconds. Latency runs from the moment a ball
+         * is classified to the moment the indexer sets the motors to eject it,
+         * minus the planned wait for the ball to reach the intake
+         */
+        std::atomic<int> ballsSeen, ballsRejected;
+        std::atomic<uint32_t> latencyMin, latencyMax, latencyCount;
+        std::atomic<uint64_t> latencyTotal;
+        /**
+         * The PROS task sampling the sensor
+         */
+        pros::task_t task;
+        /**
+         * The function run by the background task. PROS tasks take a C function pointer,
+         * so the ColorSorter passes itself in as the task parameter
+         */
+        static void taskFn(void * param);
+        /**
+         * Runs one sample of the sensor
+         */
+        void update();
+        /**
+         * Records the latency of the last eject once the indexer has acted on it
+         */
+        void recordLatency();
+    public:
+        /**
+         * The time between samples of the Optical Sensor, in milliseconds. The sensor
+         * sends new data over the smart port every 10 ms, so sampling at 5 ms means a new
+         * reading is never more than half a period old when it is seen
+         */
+        static constexpr uint32_t period = Tasks::colorSorter.period;
+        /**
+         * The diameter of a Change Up ball, in inches
+         */
+        static constexpr double ballDiameter = 6.3;
+        /**
+         * The slowest and fastest the ball speed estimate may be, in inches per second,
+         * so a ball that slipped or was stopped partway past the sensor can't make the
+         * eject times far too long or too short
+         */
+        static constexpr double minBallSpeed = 10;
+        static constexpr double maxBallSpeed = 100;
+        /**
+         * The constructor for the ColorSorter class
+         * @param idx The Indexer used to eject balls
+         * @param sensorPort The port of the Optical Sensor
+         * @param gate The proximity reading above which a ball is in front of the sensor
+         * @param distance The distance, in inches, a ball climbs above the sensor before it is ejected
+         * @param speed The starting estimate of ball speed, in inches per second
+         */
+        ColorSorter(Indexer & idx, uint8_t sensorPort, int gate, double distance, double speed);
+        /**
+         * Turns on the sensor's LED and starts the sorting task
+         */
+        void start();
+        /**
+         * Sets the color of ball to throw out
+         * @param color The color of the opponent's balls, or BallColor::none to stop sorting
+         */
+        void setRejectColor(BallColor color);
+        BallColor getRejectColor();
+        /**
+         * Classifies a hue reading from the sensor
+         * @param hue The hue, from 0 to 360
+         * @return The color of the ball, or BallColor::none if the hue isn't red or blue
+         */
+        static BallColor classify(double hue);
+        /**
+         * Functions to retrieve the sorting statistics
+         */
+        int getBallsSeen();
+        int getBallsRejected();
+        double getBallSpeed();
+        uint32_t getLatencyMin();
+        uint32_t getLatencyMax();
+        uint32_t getLatencyMean();
+        /**
+         * Prints the sorting and latency statistics to the terminal. The logging task
+         * (see Tasks.hpp) calls this every period
+         */
+        void printReport();
+};
@@ -0,0 +1,334 @@
+#pragma once
+#include "api.h"
+#include <atomic>
+#include <initializer_list>
+#include <new>
+#include <utility>
+#include "Timeline.hpp"
+/**
+ * The header file for the command framework, which lets autonomous routines be written as
+ * a graph of commands that run at the same time, instead of one long list of blocking calls.
+ *
+ * A Command is one action, like driving a distance or running the intake. Commands are
+ * combined with the group commands below: a SequentialGroup runs its commands one after
+ * another, a ParallelGroup runs them all at once until every one is done, a RaceGroup runs
+ * them all at once until any one is done, and a DeadlineGroup runs them all at once until
+ * the first one is done. The CommandScheduler runs every active command once per tick.
+ *
+ * Commands are created with makeCommand, which places them in a fixed size pool instead of
+ * on the heap. The pool is cleared with CommandPool::reset() at the start of each routine,
+ * so commands must not own anything that needs a destructor.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+
+/**
+ * The Subsystem flags are used to mark which parts of the robot a command uses.
+ * A command's requirements are a combination of these, joined with |
+ */
+namespace Subsystem
+{
+    enum : uint32_t
+    {
+        none = 0,
+        drive = 1 << 0,
+        intake = 1 << 1,
+        conveyor = 1 << 2
+    };
+}
+
+class Command
+{
+    protected:
+        /**
+         * The subsystems this command uses
+         */
+        uint32_t requirements;
+        /**
+         * The index of this command's entry in the Timeline while it runs
+         */
+        int timelineIndex;
+        /**
+         * The command that starts as soon as this one finishes, if this one is in a
+         * SequentialGroup and isn't its last command, or NULL
+         */
+        Command * next;
+    public:
+        Command(uint32_t reqs = Subsystem::none) : requirements(reqs), timelineIndex(-1), next(NULL) {}
+        virtual ~Command() {}
+        /**
+         * Called once when the command starts
+         */
+        virtual void initialize() {}
+        /**
+         * Called once every scheduler tick while the command runs
+         */
+        virtual void execute() {}
+        /**
+         * Called after every execute(). The command stops once this returns true.
+         * By default a command finishes straight away
+         */
+        virtual bool isFinished() { return true; }
+        /**
+         * Called once when the command stops
+         * @param interrupted true if the command was stopped before it finished
+         */
+        virtual void end(bool interrupted) {}
+        /**
+         * Returns the subsystems this command uses
+         */
+        uint32_t getRequirements() { return requirements; }
+        /**
+         * Sets the command that starts as soon as this one finishes. Used by SequentialGroup
+         */
+        void setNext(Command * cmd) { next = cmd; }
+        /**
+         * The name and kind of the command, as recorded in the Timeline
+         */
+        virtual const char * getName() { return "command"; }
+        virtual Timeline::Kind getKind() { return Timeline::Kind::action; }
+        /**
+         * Starts and stops the command, recording it in the Timeline. Groups and the
+         * scheduler call these instead of calling initialize() and end() directly
+         */
+        void start();
+        void stop(bool interrupted);
+};
+
+/**
+ * The CommandPool holds the memory every command is created in. It is a fixed size
+ * block of memory handed out from front to back, so creating a command never touches
+ * the heap, and reset() frees every command at once
+ */
+namespace CommandPool
+{
+    /**
+     * The size of the pool, in bytes
+     */
+    constexpr size_t size = 16384;
+    /**
+     * Hands out a block of memory from the pool
+     * @param bytes The size of the block
+     * @param align The alignment the block needs
+     * @return The block, or NULL if the pool is full
+     */
+    void * allocate(size_t bytes, size_t align);
+    /**
+     * Frees every command in the pool. Any command created before this
+     * must not be used afterwards, so every CommandScheduler first has the
+     * commands still scheduled on it cancelled. That happens when PROS ends a
+     * task partway through runToCompletion, like autonomous at the end of the period
+     */
+    void reset();
+    /**
+     * Returns the number of bytes of the pool in use
+     */
+    size_t used();
+    /**
+     * Returns the number of times reset() has been called. A command is still
+     * usable as long as this hasn't changed since it was created
+     */
+    uint32_t getGeneration();
+}
+
+/**
+ * Creates a command in the CommandPool
+ * @param args The arguments passed to the command's constructor
+ * @return The created command, or NULL if the pool is full
+ */
+template <typename T, typename... Args>
+T * makeCommand(Args &&... args)
+{
+    void * mem = CommandPool::allocate(sizeof(T), alignof(T));
+    if(mem == NULL) return NULL;
+    return new (mem) T(std::forward<Args>(args)...);
+}
+
+/**
+ * The base of the group commands, which holds the commands in the group
+ */
+class CommandGroup : public Command
+{
+    protected:
+        /**
+         * The most commands a single group can hold. Longer routines can be split
+         * into nested groups
+         */
+        static constexpr int maxCommands = 24;
+        Command * commands[maxCommands];
+        int count;
+        /**
+         * Whether each command in the group is still running. Not used by SequentialGroup
+         */
+        bool running[maxCommands];
+    public:
+        /**
+         * The constructor for a group. The group requires every subsystem
+         * that any of its commands require
+         * @param cmds The commands in the group. NULL commands are skipped
+         */
+        CommandGroup(std::initializer_list<Command *> cmds);
+        Timeline::Kind getKind() override { return Timeline::Kind::group; }
+};
+
+class SequentialGroup : public CommandGroup
+{
+    private:
+        //The index of the command currently running
+        int current;
+    public:
+        SequentialGroup(std::initializer_list<Command *> cmds);
+        void initialize() override;
+        void execute() override;
+        bool isFinished() override;
+        void end(bool interrupted) override;
+        const char * getName() override { return "sequence"; }
+};
+
+class ParallelGroup : public CommandGroup
+{
+    public:
+        ParallelGroup(std::initializer_list<Command *> cmds) : CommandGroup(cmds) {}
+        void initialize() override;
+        void execute() override;
+        bool isFinished() override;
+        void end(bool interrupted) override;
+        const char * getName() override { return "parallel"; }
+};
+
+class RaceGroup : public ParallelGroup
+{
+    public:
+        RaceGroup(std::initializer_list<Command *> cmds) : ParallelGroup(cmds) {}
+        bool isFinished() override;
+        const char * getName() override { return "race"; }
+};
+
+class DeadlineGroup : public ParallelGroup
+{
+    public:
+        /**
+         * The first command in the group is the deadline. The group ends as
+         * soon as it finishes, interrupting every other command still running
+         */
+        DeadlineGroup(std::initializer_list<Command *> cmds) : ParallelGroup(cmds) {}
+        bool isFinished() override;
+        const char * getName() override { return "deadline"; }
+};
+
+/**
+ * A command that waits for a set amount of time
+ */
+class WaitCommand : public Command
+{
+    private:
+        uint32_t time, startTime;
+    public:
+        /**
+         * @param ms The time to wait, in milliseconds
+         */
+        WaitCommand(uint32_t ms) : time(ms), startTime(0) {}
+        void initialize() override;
+        bool isFinished() override;
+        const char * getName() override { return "wait"; }
+        Timeline::Kind getKind() override { return Timeline::Kind::wait; }
+};
+
+class CommandScheduler
+{
+    private:
+        /**
+         * The most commands that can be scheduled at once
+         */
+        static constexpr int maxActive = 16;
+        Command * active[maxActive];
+        int count;
+        /**
+         * Set by requestCancel() from another task, and checked by runToCompletion
+         * each tick
+         */
+        std::atomic<bool> cancelRequested;
+        /**
+         * The time the first tick of the last runToCompletion finished, in microseconds
+         */
+        uint64_t firstTickTime;
+        /**
+         * Stops the command at index i and removes it from the active commands
+         */
+        void remove(int i, bool interrupted);
+    public:
+        /**
+         * The time between scheduler ticks, in milliseconds. It matches the 20 ms
+         * update rate TankDrive's moves are tuned for
+         */
+        static constexpr uint32_t period = 20;
+        /**
+         * The longest a simulated routine can run for, in milliseconds, so a routine
+         * that never finishes can't hang the analysis
+         */
+        static constexpr uint32_t maxSimTime = 120000;
+        //The most schedulers CommandPool::reset() can reach
+        static constexpr int maxSchedulers = 4;
+        CommandScheduler();
+        /**
+         * Cancels everything scheduled on every scheduler, before the CommandPool
+         * frees the commands. Used by CommandPool::reset()
+         */
+        static void cancelEverywhere();
+        /**
+         * Starts a command. Any active command that uses one of the same
+         * subsystems is interrupted first
+         * @param cmd The command to start
+         */
+        void schedule(Command * cmd);
+        /**
+         * Runs one tick: executes every active command, and ends the ones that finish
+         */
+        void run();
+        /**
+         * Functions to interrupt one or every active command
+         */
+        void cancel(Command * cmd);
+        void cancelAll();
+        /**
+         * Asks runToCompletion to interrupt everything and return at its next tick.
+         * Unlike cancelAll(), this is safe to call from a different task than the
+         * one running the scheduler, like the GUI. A request made while no routine
+         * is running is dropped when the next one starts
+         */
+        void requestCancel();
+        /**
+         * Returns whether a command is active
+         */
+        bool isScheduled(Command * cmd);
+        /**
+         * Schedules a command and runs the scheduler every period until it finishes.
+         * Used to run a whole routine from autonomous(). While the Timeline is
+         * simulating, the simulated clock is moved forward a period each tick
+         * instead of waiting, and the routine gives up after maxSimTime
+         * @param cmd The command to run
+         * @param monitorId The TaskMonitor id of the task running the scheduler, so each
+         * tick is counted as that task's work. -1 if the task isn't registered
+         */
+        void runToCompletion(Command * cmd, int monitorId = -1);
+        /**
+         * Returns the time the first tick of the last runToCompletion finished, in
+         * microseconds since the program started. The first motor commands of a routine
+         * have all been sent by then. 0 if nothing has been run on the robot yet
+         */
+        uint64_t getFirstTickTime();
+};
+
+/**
+ * Short functions for building routines out of commands, all created in the CommandPool
+ */
+namespace Commands
+{
+    Command * sequence(std::initializer_list<Command *> cmds);
+    Command * parallel(std::initializer_list<Command *> cmds);
+    Command * race(std::initializer_list<Command *> cmds);
+    Command * deadline(std::initializer_list<Command *> cmds);
+    Command * wait(uint32_t ms);
+}
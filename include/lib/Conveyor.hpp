@@ -1,6 +1,7 @@
 #pragma once
 #include "api.h"
 #include "library.hpp"
+#include "JamDetector.hpp"
 #include <vector>
 #include <initializer_list>
 class Conveyor
@@ -15,6 +16,11 @@ class Conveyor
     * push up or down an object
      */ 
         pros::controller_digital_e_t upButton, downButton;
+    /**
+     * Every power sent to the motors goes through the JamDetector, which
+     * clears a jammed ball by running the conveyor backwards for a moment
+     */
+        JamDetector jam;
     /**
      * Telemetry structs (defined in library.hpp) that hold the 
      * telemetry data for each motor. Data is displayed on the GUI
@@ -42,6 +48,26 @@ class Conveyor
      * @param controller The ID of the controller to get input from
      */ 
         void driver(pros::controller_id_e_t controller);
+    /**
+     * The same as driver(), but using a ControllerState (defined in library.hpp)
+     * that has already been read, either from the controller or from a recording
+     * @param input The controller state to get button presses from
+     */ 
+        void driver(const ControllerState & input);
+    /**
+     * Works out what driver() would send to the motors, without sending it
+     * @param input The controller state to get button presses from
+     * @param out The outputs to fill in the conveyor's part of (see library.hpp)
+     */ 
+        void plan(const ControllerState & input, MotorOutputs & out) const;
+    /**
+     * Sets the power of the motors, from -127 (down) to 127 (up)
+     */ 
+        void setPower(int power);
+    /**
+     * Returns the power the conveyor was last given, from -127 (down) to 127 (up)
+     */ 
+        int getPower();
     /**
      * A function to set the motor(s) to move objects up
      */ 
@@ -58,4 +84,13 @@ class Conveyor
      * Functions that return the telemetry data for the motor group
      */ 
         //Telemetry getTelemetry();
+    /**
+     * A function to retrieve the ports of the conveyor motor(s)
+     * @return A vector of the ports of the conveyor motor(s)
+     */ 
+        std::vector<int> getMotorPorts();
+    /**
+     * A function to retrieve the conveyor's JamDetector, to change its thresholds or read its jam count
+     */
+        JamDetector & getJamDetector();
 };
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+/**
+ * The header file for the DoubleBuffer class, which passes a value from one task to any
+ * number of others without a mutex.
+ *
+ * One task (the writer) publishes a new value with write(), and any task can get the
+ * latest complete value with read(). The writer never waits for the readers, so a slow
+ * reader (like the GUI or the logger) can never hold up the task writing the value (like
+ * the sensor task). A reader that is interrupted by the writer while copying the value
+ * notices and copies it again, so it never sees a half written value.
+ *
+ * There must only be one writer. T should be a small struct of plain values, as it is
+ * copied on every read and write.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments below explain the inner workings of each function
+ */
+template <typename T>
+class DoubleBuffer
+{
+    private:
+        /**
+         * The two copies of the value. The writer always writes the one readers
+         * weren't told about last
+         */
+        T slots[2];
+        /**
+         * The version of each slot. It is odd while the slot is being written, and goes
+         * up by 2 every time the slot is written
+         */
+        std::atomic<uint32_t> versions[2];
+        //The slot holding the latest complete value
+        std::atomic<int> latest;
+    public:
+        DoubleBuffer(const T & initial = T()) : latest(0) {
+            slots[0] = initial;
+            slots[1] = initial;
+            versions[0] = 0;
+            versions[1] = 0;
+        }
+        /**
+         * Publishes a new value. Only one task may call this
+         * @param value The value to publish
+         */
+        void write(const T & value) {
+            /**
+             * The slot readers aren't using is marked as being written, filled in,
+             * and marked as done, before readers are pointed at it. A reader that
+             * started on this slot before the last flip sees its version change
+             */
+            int slot = 1 - latest.load(std::memory_order_relaxed);
+            versions[slot].fetch_add(1, std::memory_order_acq_rel);
+            slots[slot] = value;
+            versions[slot].fetch_add(1, std::memory_order_release);
+            latest.store(slot, std::memory_order_release);
+        }
+        /**
+         * Returns the latest published value, or the initial value if nothing has been
+         * published yet. Any task may call this
+         */
+        T read() const {
+            /**
+             * The copy only counts if the slot wasn't being written when it started
+             * (the version was even) and wasn't written while it was copied (the version
+             * didn't change). Otherwise the latest slot is looked up and copied again.
+             * The writer only ever touches one slot per write, so this almost never
+             * needs a second try
+             */
+            T value;
+            while(true) {
+                int slot = latest.load(std::memory_order_acquire);
+                uint32_t before = versions[slot].load(std::memory_order_acquire);
+                if(before & 1) continue;
+                value = slots[slot];
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(versions[slot].load(std::memory_order_relaxed) == before) return value;
+            }
+        }
+        /**
+         * Returns how many values have been published. Readers can compare this
+         * between calls to tell whether anything new was written
+         */
+        uint32_t getWrites() const {
+            return (versions[0].load(std::memory_order_acquire) + versions[1].load(std::memory_order_acquire)) / 2;
+        }
+};
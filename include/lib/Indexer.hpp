@@ -0,0 +1,182 @@
+#pragma once
+#include "api.h"
+#include "library.hpp"
+#include "Tasks.hpp"
+#include "intake.hpp"
+#include "Conveyor.hpp"
+#include <atomic>
+/**
+ * The header file for the Indexer class, which runs the Intake and Conveyor together
+ * in closed loop using ADI line trackers placed along the conveyor.
+ *
+ * Three line trackers sit at the bottom, middle and top of the conveyor. A ball in front of
+ * a line tracker reflects more light back into it, so its reading drops. The indexer uses those
+ * readings to know where the balls are, and runs a state machine (see IndexerState in library.hpp)
+ * in its own task, so autonomous routines can wait for balls to actually be scored instead of
+ * waiting a fixed amount of time.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class Indexer
+{
+    private:
+        /**
+         * The Intake and Conveyor objects the indexer drives
+         */
+        Intake & intake;
+        Conveyor & conveyor;
+        /**
+         * The ADI ports ('A' to 'H') of the line trackers at the bottom,
+         * middle and top of the conveyor
+         */
+        uint8_t bottomPort, middlePort, topPort;
+        /**
+         * How far, in calibrated analog units, a line tracker's reading has
+         * to drop before a ball is considered to be in front of it
+         */
+        int threshold;
+        /**
+         * The current state of the state machine, and the state last requested by
+         * another task. Every request adds one to requestCount, and the indexer task
+         * moves to the requested state on its next update, then sets handledCount to
+         * match. A request is pending while the two differ, and the new state is
+         * published before the request stops being pending, so other tasks always
+         * see one or the other
+         */
+        std::atomic<IndexerState> state;
+        std::atomic<IndexerState> requested;
+        std::atomic<uint32_t> requestCount, handledCount;
+        /**
+         * The state the indexer was in before an eject started, which it goes back
+         * to once the eject is done
+         */
+        IndexerState resumeState;
+        /**
+         * The number of balls still to be shot out the top, and the total
+         * number of balls the indexer has seen leave the top of the conveyor
+         */
+        std::atomic<int> ballsToShoot, ballsShot;
+        /**
+         * Whether a ball was in front of the top line tracker during the last update,
+         * used to find the moment a ball leaves the conveyor
+         */
+        bool topWasBlocked;
+        /**
+         * The time, in milliseconds, the current state was entered, and how long
+         * the current shooting or ejecting state may last before giving up
+         */
+        uint32_t stateStart, stateTimeout;
+        /**
+         * The time, in microseconds, the motors were last set to eject a ball.
+         * Used by the ColorSorter to measure how long ejecting takes
+         */
+        std::atomic<uint64_t> lastEjectTime;
+        /**
+         * The PROS task running the state machine
+         */
+        pros::task_t task;
+        /**
+         * The function run by the background task. PROS tasks take a C function pointer,
+         * so the Indexer passes itself in as the task parameter
+         */
+        static void taskFn(void * param);
+        /**
+         * Hands a new state to the indexer task and wakes it up, so the request
+         * is acted on straight away instead of at the next period
+         * @param s The state to move to
+         */
+        void request(IndexerState s);
+        /**
+         * Sets the motors for a newly entered state
+         * @param s The state being entered
+         */
+        void enterState(IndexerState s);
+        /**
+         * Runs one update of the state machine
+         */
+        void update();
+    public:
+        /**
+         * The longest time between updates of the indexer task, in milliseconds.
+         * The task also updates as soon as a new state is requested
+         */
+        static constexpr uint32_t period = Tasks::indexer.period;
+        /**
+         * The constructor for the Indexer class
+         * @param in The Intake object that pulls balls in
+         * @param conv The Conveyor object that moves balls up to be scored
+         * @param bottom The ADI port of the line tracker at the bottom of the conveyor
+         * @param middle The ADI port of the line tracker at the middle of the conveyor
+         * @param top The ADI port of the line tracker at the top of the conveyor
+         * @param thresh How far a line tracker's reading must drop for a ball to be detected
+         */
+        Indexer(Intake & in, Conveyor & conv, uint8_t bottom, uint8_t middle, uint8_t top, int thresh);
+        /**
+         * Calibrates the line trackers and starts the indexer task. The line trackers
+         * are calibrated against an empty conveyor, and calibration blocks for about
+         * half a second, so this should be called in initialize()
+         */
+        void start();
+        /**
+         * Functions to check whether there is a ball in front of each line tracker
+         */
+        bool ballAtBottom();
+        bool ballAtMiddle();
+        bool ballAtTop();
+        /**
+         * Starts pulling balls in, moving them up the conveyor until a ball reaches the
+         * top, then stopping the conveyor while the intake keeps filling the bottom
+         */
+        void intakeBalls();
+        /**
+         * Stops the intake and conveyor and holds the balls where they are
+         */
+        void hold();
+        /**
+         * Starts shooting balls out the top of the conveyor without waiting for them
+         * @param balls The number of balls to shoot
+         * @param timeout The longest time, in milliseconds, to keep trying before giving up
+         */
+        void shoot(int balls, uint32_t timeout = 3000);
+        /**
+         * Shoots balls out the top of the conveyor and waits until they have all left.
+         * The indexer holds once the last ball is through
+         * @param balls The number of balls to score
+         * @param timeout The longest time, in milliseconds, to wait before giving up
+         * @return true if every ball was scored, false if the timeout ran out first
+         */
+        bool score(int balls, uint32_t timeout = 3000);
+        /**
+         * Runs the conveyor and intake backwards to throw a ball out the bottom,
+         * then goes back to whatever the indexer was doing before
+         * @param time How long, in milliseconds, to run backwards
+         */
+        void eject(uint32_t time);
+        /**
+         * Returns control of the intake and conveyor motors, putting the indexer in its
+         * idle state. Driver control must call this before using Intake::driver
+         * and Conveyor::driver
+         */
+        void stop();
+        /**
+         * Functions to retrieve the current state and the total number of balls shot
+         */
+        IndexerState getState();
+        int getBallsShot();
+        /**
+         * Returns whether the indexer is shooting, or has been asked to shoot and
+         * hasn't started yet
+         */
+        bool isShooting();
+        /**
+         * Returns whether the conveyor is carrying balls up, whoever is driving it, and
+         * isn't clearing a jam or stopped on one. Any task may call this
+         */
+        bool isConveyorRunningUp();
+        /**
+         * Returns the time, in microseconds, the motors were last set to eject a ball
+         */
+        uint64_t getLastEjectTime();
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include "api.h"
+/**
+ * The header file for the Inertial class, which wraps the V5 Inertial Sensor (IMU).
+ *
+ * The IMU has to sit still for about 2 seconds while it calibrates, so calibrate() is
+ * called from initialize(), as the program starts, and again while the robot is disabled
+ * (see PreArm.hpp) in case the IMU wasn't plugged in then. It only calibrates once per
+ * program run, so the heading carries on from autonomous into driver control. Until the IMU has
+ * finished calibrating, or if it isn't plugged in, every reading is PROS_ERR_F, the same
+ * as a disconnected sensor, so anything using it has one case to handle.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class Inertial
+{
+    private:
+        uint8_t port;
+        //Whether calibrate() has ever started a calibration
+        bool calibrationStarted;
+        /**
+         * How the IMU is mounted. It sits flat with its y axis pointing forwards, so its x
+         * axis points across the robot: the robot pitches about the IMU's x axis (its roll)
+         * and rolls about its y axis (its pitch). The signs turn those into the robot's
+         * angles as getPitch and getRoll give them. If the IMU is moved, these and
+         * getForwardAccel are the only things that change
+         */
+        static constexpr double pitchSign = 1;
+        static constexpr double rollSign = 1;
+    public:
+        //Inches per second squared in one g, to turn the accelerometer's readings into inches
+        static constexpr double gravity = 386.09;
+        /**
+         * The constructor for the Inertial class
+         * @param imuPort The smart port the IMU is plugged into
+         */
+        Inertial(uint8_t imuPort);
+        /**
+         * Starts calibrating the IMU, if it has never been calibrated, and returns straight
+         * away. The robot must not move until isReady() returns true
+         * @return true if a calibration is running or has finished
+         */
+        bool calibrate();
+        /**
+         * Returns whether the IMU is plugged in and done calibrating
+         */
+        bool isReady();
+        /**
+         * Returns the heading (0 to 360, clockwise like a compass), in degrees, or PROS_ERR_F
+         * if the IMU isn't ready
+         */
+        double getHeading();
+        /**
+         * Return the robot's pitch (positive with the nose up) and roll (positive with the
+         * right side down), in degrees, or PROS_ERR_F if the IMU isn't ready. These are the
+         * robot's angles, not the IMU's own, which depend on how it is mounted (see above)
+         */
+        double getPitch();
+        double getRoll();
+        /**
+         * Returns the heading without wrapping at 360, so a full clockwise turn reads 360,
+         * or PROS_ERR_F if the IMU isn't ready
+         */
+        double getRotation();
+        /**
+         * Returns how fast the robot is turning, in degrees per second, clockwise like the
+         * heading, or PROS_ERR_F if the IMU isn't ready
+         */
+        double getYawRate();
+        /**
+         * Returns the acceleration towards the front of the robot, in g, or PROS_ERR_F if
+         * the IMU isn't ready. The IMU must be mounted flat, with its y axis pointing forwards
+         */
+        double getForwardAccel();
+        /**
+         * Returns the port the IMU is plugged into
+         */
+        uint8_t getPort();
+};
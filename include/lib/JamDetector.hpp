@@ -0,0 +1,149 @@
+#pragma once
+#include "api.h"
+#include <atomic>
+#include <vector>
+/**
+ * The header file for the JamDetector class, which notices a ball jamming a mechanism
+ * (the Intake or the Conveyor) and clears it by running the mechanism backwards for a
+ * moment, then forwards again.
+ *
+ * The Intake and Conveyor are run at a fixed power with no feedback, so a jammed ball stalls
+ * their motors without anything noticing: they heat up, and nothing is scored until the driver
+ * sees it. Each mechanism owns a JamDetector, and every power it is given goes through
+ * setPower(), so it works the same whoever is driving it: driver control, the Indexer, or a
+ * command in an autonomous routine.
+ *
+ * A motor is stalled when it is being driven but is turning slower than stallVelocity, while
+ * drawing more than stallCurrent or hitting its current limit (which the PowerManager may have
+ * lowered below stallCurrent). If any of the mechanism's motors stays stalled for jamTime, that
+ * is a jam, and the mechanism:
+ * - runs backwards at reversePower for reverseTime, to free the ball, ignoring the power it is
+ *   given in the meantime
+ * - goes back to the power it was last given, and isn't checked again for spinUpTime, while
+ *   the motors get back up to speed
+ * This repeats while the mechanism keeps jamming, as a few tries usually get a ball through.
+ * A ball that comes straight back maxRepeats times in a row isn't going to get through, so
+ * the detector gives up: it stops the motors, counts it in the stats for the logging task to
+ * report, and leaves them stopped until the mechanism is given a different power. The
+ * detector also waits spinUpTime after the power is changed, so starting up against a ball
+ * isn't taken as a jam.
+ *
+ * update() is run by the jam task (see Tasks.hpp), which is the only task that reads the
+ * motors for it. While the Indexer is ejecting a ball, the jam task pauses the detector, as
+ * the eject runs the mechanisms backwards against whatever is in the way on purpose.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class JamDetector
+{
+    public:
+        /**
+         * The thresholds of the detector and the unjam cycle
+         */
+        struct Thresholds
+        {
+            //The slowest a driven motor can turn before it counts as stalled, in rpm
+            double stallVelocity = 15;
+            //The current a stalled motor draws, in mA
+            int stallCurrent = 1800;
+            //How long a motor has to be stalled before it is a jam, in milliseconds
+            uint32_t jamTime = 150;
+            //How long, and how hard (0 to 127), the mechanism runs backwards to clear a jam
+            uint32_t reverseTime = 250;
+            int reversePower = 100;
+            //How long after the power is changed, or a jam is cleared, before stalls are checked, in milliseconds
+            uint32_t spinUpTime = 300;
+            //The least power (0 to 127) the motors have to be given to be checked at all
+            int minPower = 30;
+            //The repeats in a row (see repeatTime) after which the detector gives up
+            uint32_t maxRepeats = 3;
+        };
+        /**
+         * The jams the detector has seen since the program started
+         */
+        struct Stats
+        {
+            //The number of jams, and of those that came straight back after an unjam cycle
+            uint32_t jams;
+            uint32_t repeats;
+            //The number of times the detector gave up and stopped the mechanism
+            uint32_t giveUps;
+            //The port of the motor that stalled last, or 0 if there hasn't been a jam
+            int lastPort;
+        };
+        /**
+         * A jam that comes within this long (milliseconds) of the last unjam cycle ending
+         * counts as the same jam coming straight back
+         */
+        static constexpr uint32_t repeatTime = 1000;
+
+        /**
+         * The constructor for the JamDetector class
+         * @param ports The ports of the mechanism's motors
+         */
+        JamDetector(const std::vector<int> & ports);
+        /**
+         * Changes the thresholds. It must be called before the jam task starts
+         */
+        void configure(const Thresholds & t);
+        Thresholds getThresholds();
+        /**
+         * Sets the power of the motors, from -127 to 127, unless a jam is being cleared, in
+         * which case it is sent once the unjam cycle finishes, or the detector has given up
+         * on this power, in which case the motors stay stopped. Any task may call this
+         */
+        void setPower(int power);
+        /**
+         * Reads the motors and runs the unjam cycle. Only the jam task may call this
+         * @param paused Whether stalls are ignored this update, while something drives the
+         *               mechanism against a ball on purpose. The detector waits spinUpTime
+         *               again once it is no longer paused
+         */
+        void update(bool paused = false);
+        /**
+         * Returns the power the mechanism was last given, which may not be what the
+         * motors are running at while a jam is being cleared. Any task may call this
+         */
+        int getPower();
+        /**
+         * Returns whether a jam is being cleared right now. Any task may call this
+         */
+        bool isUnjamming();
+        /**
+         * Returns whether the detector has given up on a jam and stopped the mechanism,
+         * until it is given a different power. Any task may call this
+         */
+        bool hasGivenUp();
+        /**
+         * Returns the jams seen so far. Any task may call this
+         */
+        Stats getStats();
+    private:
+        std::vector<int> motorPorts;
+        Thresholds thresholds;
+        //The power the mechanism was last given, and whether the unjam cycle has the motors
+        std::atomic<int> commanded;
+        std::atomic<bool> unjamming;
+        //Whether the detector has given up, and the power it gave up on
+        std::atomic<bool> givenUp;
+        std::atomic<int> givenUpPower;
+        //The power the detector last saw, so it can tell when it changes
+        int lastCommanded;
+        /**
+         * The time (in milliseconds) the motors started stalling, or 0 if they aren't, the
+         * time stalls are checked again from, the time the current unjam cycle ends, and the
+         * time the last one ended
+         */
+        uint32_t stallStart, checkFrom, reverseUntil, lastUnjam;
+        //The repeats in a row so far
+        uint32_t repeatRun;
+        std::atomic<uint32_t> jams, repeats, giveUps;
+        std::atomic<int> lastPort;
+
+        //Sends a power to every motor
+        void write(int power);
+        //Returns the port of a stalled motor, or 0 if none of them are
+        int findStall();
+};
@@ -0,0 +1,213 @@
+#pragma once
+#include "api.h"
+#include "library.hpp"
+#include "DoubleBuffer.hpp"
+#include <atomic>
+#include <vector>
+/**
+ * The header file for the Localizer class, a particle filter (Monte Carlo localization)
+ * that finds where the robot is on the field from Distance sensors pointed at the field
+ * walls, and takes the error that builds up out of the odometry.
+ *
+ * The filter keeps a few hundred guesses (particles) of the robot's pose on the field. Each
+ * update it:
+ * - moves every particle by how far the odometry says the robot moved, plus some noise, as
+ *   the odometry is never quite right
+ * - works out what each Distance sensor would read from every particle, if the field were
+ *   an empty 144 inch square, and weights each particle by how well that matches what the
+ *   sensors really read. Game elements and other robots are closer than the wall, so a
+ *   reading that doesn't match at all is still given a small chance
+ * - if most of the weight is on a few particles, draws a new set from the old one, with
+ *   each particle picked in proportion to its weight
+ * The weighted average of the particles is the robot's pose. Once the particles agree
+ * closely enough, the odometry is moved to match it (see Odometry::correct).
+ *
+ * The particles are kept as a structure of arrays (one array each of x, y, heading and
+ * weight), sized for maxParticles when compiled, so every step is a plain loop over
+ * floats with nothing allocated. How many of them are used can be changed to trade
+ * accuracy for CPU time (see Benchmark::compareParticleCounts).
+ *
+ * Poses here are on the field: inches from the corner to the left of the driver station,
+ * with x along the driver station wall and y away from it, and the heading clockwise from
+ * y. The odometry's pose is from where the robot started, so the filter is told where on
+ * the field that was.
+ *
+ * update() is run by the localizer task (see Tasks.hpp), at a lower rate than the
+ * odometry, and is the only code that reads the Distance sensors. It publishes the pose
+ * through a DoubleBuffer, so any task can read it with getPose().
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class Localizer
+{
+    public:
+        /**
+         * A Distance sensor and where it is on the robot: x to the right of the middle of
+         * the robot and y forwards of it, in inches, and the way it points, in degrees
+         * clockwise from the front
+         */
+        struct Sensor
+        {
+            uint8_t port;
+            double x;
+            double y;
+            double angle;
+        };
+        /**
+         * The filter's estimate: the pose on the field, how far the particles are spread
+         * around it (the standard deviation of their positions, in inches), and whether
+         * the last update used any sensor readings
+         */
+        struct Estimate
+        {
+            Pose pose;
+            double spread;
+            bool sensed;
+        };
+        //The most particles and sensors the filter can hold
+        static constexpr int maxParticles = 400;
+        static constexpr int maxSensors = 4;
+        //The length of each side of the field, in inches
+        static constexpr double fieldSize = 144;
+        /**
+         * A reading is only used if it is shorter than this (inches), as the sensor gets
+         * less accurate beyond it and reads 9999 mm when it sees nothing at all, and if the
+         * sensor is at least this confident in it (0 to 63)
+         */
+        static constexpr double maxRange = 78;
+        static constexpr int minConfidence = 32;
+        /**
+         * How noisy a reading is: the larger of a fixed amount and a fraction of the
+         * distance, in inches, as the sensor is accurate to about 5% over longer distances
+         */
+        static constexpr double minReadingNoise = 0.6;
+        static constexpr double readingNoiseScale = 0.05;
+        /**
+         * The chance given to a reading that doesn't match the wall at all, as
+         * something else on the field may be in the way
+         */
+        static constexpr double unexpectedChance = 0.05;
+        /**
+         * How much noise is added to each particle's movement, as a fraction of the
+         * movement plus a fixed amount, for the distance (inches) and the turn (radians)
+         */
+        static constexpr double moveNoiseScale = 0.1;
+        static constexpr double moveNoise = 0.02;
+        static constexpr double turnNoiseScale = 0.05;
+        static constexpr double turnNoise = 0.002;
+        /**
+         * The odometry is only corrected when the particles are spread less than this
+         * (inches), and the correction is more than correctionMin (inches) or
+         * correctionMinAngle (degrees), so it isn't nudged around by the filter's own noise
+         */
+        static constexpr double maxCorrectionSpread = 3;
+        static constexpr double correctionMin = 0.25;
+        static constexpr double correctionMinAngle = 1;
+
+        /**
+         * The constructor for the Localizer class
+         * @param sensorList The Distance sensors and where they are on the robot. Only the
+         *                   first maxSensors are used
+         * @param start Where the robot starts on the field, used by reset()
+         * @param particles The number of particles to use, up to maxParticles
+         */
+        Localizer(const std::vector<Sensor> & sensorList, Pose start, int particles = 200);
+        /**
+         * Spreads the particles around where the robot starts on the field, and makes the
+         * odometry's {0, 0, 0} that pose. It takes effect at the next update. The
+         * odometry should be reset at the same time
+         * @param start The starting pose on the field, or the one passed to the constructor
+         * @param spread How far the robot may be from start, in inches
+         */
+        void reset();
+        void reset(Pose start, double spread = 1);
+        /**
+         * Reads the odometry and the Distance sensors, steps the filter, publishes the
+         * estimate and corrects the odometry. Only the localizer task may call this
+         */
+        void update();
+        /**
+         * Steps the filter with a pose from the odometry and a reading from each sensor,
+         * without touching any hardware, so it can be run on made up data.
+         * Only one task may call this and update() on the same Localizer
+         * @param odomPose The odometry's pose
+         * @param readings The reading of each sensor, in inches, or a negative number for a
+         *                 sensor that has no usable reading
+         * @return true if any reading was used
+         */
+        bool step(Pose odomPose, const double * readings);
+        /**
+         * Return the latest estimate, or just its pose. Any task may call these
+         */
+        Estimate getEstimate();
+        Pose getPose();
+        /**
+         * Changes the number of particles used, up to maxParticles. It takes effect at the
+         * next reset
+         */
+        void setParticleCount(int particles);
+        int getParticleCount();
+        /**
+         * Returns what a sensor at (x, y), pointing along heading (degrees, clockwise
+         * from y), would read on an empty field, in inches
+         */
+        static double expectedDistance(double x, double y, double heading);
+        /**
+         * Turn a pose from the odometry into a pose on the field and back again,
+         * using the start passed to reset()
+         */
+        Pose toField(Pose odomPose);
+        Pose toOdom(Pose fieldPose);
+    private:
+        Sensor sensors[maxSensors];
+        int sensorCount;
+        /**
+         * The particles, twice over: resampling copies from one set into the other, then
+         * the two are swapped. x and y are in inches and heading is in radians
+         */
+        float xs[2][maxParticles];
+        float ys[2][maxParticles];
+        float headings[2][maxParticles];
+        float weights[maxParticles];
+        //The sin and cos of each particle's heading, worked out once per step for every sensor to use
+        float sins[maxParticles];
+        float coss[maxParticles];
+        //Which of the two sets is in use, and how many particles are used
+        int current;
+        int count;
+        int nextCount;
+        /**
+         * The odometry pose the particles were last moved to, and whether there is one
+         */
+        Pose lastOdom;
+        bool started;
+        //Where the robot starts on the field, and where the odometry's {0, 0, 0} is on the field
+        Pose startPose;
+        Pose origin;
+        //The pose asked for by reset(), which the localizer picks up at its next update
+        Pose resetPose;
+        double resetSpread;
+        std::atomic<bool> resetRequested;
+        /**
+         * The correction last given to the odometry, and the odometry's correction count
+         * when it was given, so the jump it makes in the odometry isn't taken as movement
+         */
+        Pose pendingCorrection;
+        bool correctionPending;
+        uint32_t seenCorrections;
+        DoubleBuffer<Estimate> published;
+        //The state of the random number generator
+        uint32_t rng;
+
+        //Returns a random number from 0 to 1, and one from a normal distribution with a standard deviation of 1
+        float uniform();
+        float gaussian();
+        //Puts the particles around the pose asked for by reset()
+        void scatter();
+        //Draws a new set of particles from the current one, in proportion to their weights
+        void resample();
+        //Works out the weighted average pose of the particles, and how spread out they are
+        Estimate estimate(bool sensed);
+};
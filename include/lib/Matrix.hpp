@@ -0,0 +1,84 @@
+#pragma once
+/**
+ * The header file for the Matrix class template, a matrix whose size is fixed when the
+ * code is compiled.
+ *
+ * The numbers are stored in the object itself, so a Matrix never allocates on the heap
+ * and can live on a task's stack, and the loops over its rows and columns have constant
+ * bounds the compiler can unroll. Multiplying matrices of the wrong sizes doesn't compile.
+ *
+ * Only what the filters in this library need is here: adding, multiplying and
+ * transposing. There is no inverse, as the filters update one measurement at a time,
+ * which only ever divides by a single number (see PoseEKF.cpp).
+ *
+ * The whole class lives in this header so the compiler can inline it. The comments in
+ * this header file explain the purpose of each member object or function, while the
+ * comments below explain the inner workings of each function
+ */
+template <int Rows, int Cols>
+class Matrix
+{
+    private:
+        double m[Rows][Cols];
+    public:
+        /**
+         * Returns a matrix of zeroes
+         */
+        static Matrix zero() {
+            Matrix r;
+            for(int i = 0; i < Rows; i++)
+                for(int j = 0; j < Cols; j++) r.m[i][j] = 0;
+            return r;
+        }
+        /**
+         * Returns the identity matrix. Only square matrices have one
+         */
+        static Matrix identity() {
+            static_assert(Rows == Cols, "Only a square matrix has an identity");
+            Matrix r = zero();
+            for(int i = 0; i < Rows; i++) r.m[i][i] = 1;
+            return r;
+        }
+        /**
+         * Access the number in row i, column j, counting from 0
+         */
+        double & operator()(int i, int j) { return m[i][j]; }
+        double operator()(int i, int j) const { return m[i][j]; }
+
+        Matrix operator+(const Matrix & o) const {
+            Matrix r;
+            for(int i = 0; i < Rows; i++)
+                for(int j = 0; j < Cols; j++) r.m[i][j] = m[i][j] + o.m[i][j];
+            return r;
+        }
+        Matrix operator-(const Matrix & o) const {
+            Matrix r;
+            for(int i = 0; i < Rows; i++)
+                for(int j = 0; j < Cols; j++) r.m[i][j] = m[i][j] - o.m[i][j];
+            return r;
+        }
+        Matrix operator*(double s) const {
+            Matrix r;
+            for(int i = 0; i < Rows; i++)
+                for(int j = 0; j < Cols; j++) r.m[i][j] = m[i][j] * s;
+            return r;
+        }
+        template <int OCols>
+        Matrix<Rows, OCols> operator*(const Matrix<Cols, OCols> & o) const {
+            Matrix<Rows, OCols> r;
+            for(int i = 0; i < Rows; i++) {
+                for(int j = 0; j < OCols; j++) {
+                    double sum = 0;
+                    for(int k = 0; k < Cols; k++) sum += m[i][k] * o(k, j);
+                    r(i, j) = sum;
+                }
+            }
+            return r;
+        }
+        Matrix<Cols, Rows> transpose() const {
+            Matrix<Cols, Rows> r;
+            for(int i = 0; i < Rows; i++)
+                for(int j = 0; j < Cols; j++) r(j, i) = m[i][j];
+            return r;
+        }
+};
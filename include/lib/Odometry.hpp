@@ -0,0 +1,85 @@
+#pragma once
+#include "api.h"
+#include "library.hpp"
+#include "TankDrive.hpp"
+#include "DoubleBuffer.hpp"
+#include <atomic>
+/**
+ * The header file for the Odometry class, which keeps track of where the robot is on
+ * the field (its Pose, defined in library.hpp) from how far each side of the drivetrain
+ * has turned.
+ *
+ * update() is run by the odometry task (see Tasks.hpp) with every new set of encoder
+ * readings from the sensor task, and publishes the new pose through a DoubleBuffer, so
+ * any task can read it with getPose() without waiting for the odometry task.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class Odometry
+{
+    private:
+        /**
+         * The drivetrain, used to turn encoder degrees into inches and for the width of the base
+         */
+        TankDrive & drive;
+        /**
+         * The encoder readings, in degrees, from the last update, and whether there
+         * has been a last update to compare against
+         */
+        double lastLeft, lastRight;
+        bool started;
+        /**
+         * The pose the odometry task is working on, with the heading in radians, and
+         * the last pose it published
+         */
+        double x, y, theta;
+        DoubleBuffer<Pose> published;
+        /**
+         * The pose asked for by reset(), which the odometry task picks up at its next update
+         */
+        Pose resetPose;
+        std::atomic<bool> resetRequested;
+        /**
+         * The change asked for by correct(), which the odometry task adds at its next
+         * update, and the number of corrections it has added
+         */
+        Pose correction;
+        std::atomic<bool> correctionRequested;
+        std::atomic<uint32_t> corrections;
+    public:
+        /**
+         * The constructor for the Odometry class. The robot starts at {0, 0, 0}
+         * @param d The drivetrain the encoders belong to
+         */
+        Odometry(TankDrive & d);
+        /**
+         * Moves the pose forward by how far each side has turned since the last update.
+         * Only the odometry task may call this
+         * @param leftDeg The position of the left side, in degrees
+         * @param rightDeg The position of the right side, in degrees
+         */
+        void update(double leftDeg, double rightDeg);
+        /**
+         * Sets the pose the robot is at. It takes effect at the next update
+         * @param start The pose to start from
+         */
+        void reset(Pose start = {0, 0, 0});
+        /**
+         * Moves the pose by the given change, at the next update, without losing any movement
+         * between now and then. It is used by the Localizer (see Localizer.hpp) to take out
+         * the error that builds up. A correction asked for while one is still waiting is ignored
+         * @param change The distance to move x and y, in inches, and theta, in degrees
+         * @return true if the correction will be added
+         */
+        bool correct(Pose change);
+        /**
+         * Returns the number of corrections that have been added to the pose
+         */
+        uint32_t getCorrections();
+        /**
+         * Returns the latest pose. Any task may call this
+         */
+        Pose getPose();
+};
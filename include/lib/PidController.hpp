@@ -0,0 +1,161 @@
+#pragma once
+/**
+ * The header file for the PidController class template, a PID controller that
+ * can be reused by any subsystem that needs to drive a value to a target.
+ *
+ * The whole class lives in this header so the compiler can inline update() into
+ * the control loops that call it. Optional behaviour is picked with the Features
+ * template parameter rather than with runtime flags or virtual functions, so a
+ * controller only pays for the features it uses, and nothing is allocated on the heap.
+ */
+
+/**
+ * The PidFeature flags select the optional behaviour of a PidController. They can be
+ * combined with |, for example PidFeature::integralClamp | PidFeature::outputLimit
+ *
+ * integralClamp: the integral is kept between -integralLimit and integralLimit
+ * resetOnCross: the integral is cleared whenever the error changes sign, so it
+ *               can't push the system past the target
+ * derivativeFilter: the derivative is passed through a low-pass filter, since the raw
+ *                   difference between two encoder readings is very noisy
+ * derivativeOnMeasurement: the derivative is taken from the measurement instead of the
+ *                          error, so changing the target doesn't cause a spike in the output
+ * outputLimit: the output is kept between -outputLimit and outputLimit
+ */
+namespace PidFeature
+{
+    enum : unsigned
+    {
+        none = 0,
+        integralClamp = 1 << 0,
+        resetOnCross = 1 << 1,
+        derivativeFilter = 1 << 2,
+        derivativeOnMeasurement = 1 << 3,
+        outputLimit = 1 << 4,
+        all = integralClamp | resetOnCross | derivativeFilter | derivativeOnMeasurement | outputLimit
+    };
+}
+
+template <typename T, unsigned Features = PidFeature::all>
+class PidController
+{
+    private:
+        /**
+         * The PID constant values, kP for the proportional constant,
+         * kI for the integral constant, and kD for the derivative constant
+         */
+        T kP, kI, kD;
+        /**
+         * The largest magnitude the integral may reach (integralClamp), the
+         * largest magnitude of the output (outputLimit), and the weight given to a
+         * new derivative sample by the low-pass filter (derivativeFilter), between 0 and 1
+         */
+        T integralLimit, outLimit, filterAlpha;
+        /**
+         * The running state of the controller
+         */
+        T integral, derivative, prevError, prevMeasurement, error;
+        /**
+         * Whether update() has been called since the last reset(). The derivative
+         * needs a previous value, so it is left at zero on the first update
+         */
+        bool started;
+        //Returns x kept between -limit and limit
+        static T clamp(T x, T limit) {
+            if(x > limit) return limit;
+            if(x < -limit) return -limit;
+            return x;
+        }
+    public:
+        /**
+         * The constructor for the PidController class
+         * @param Pconst The value of the proportional constant
+         * @param Iconst The value of the integral constant
+         * @param Dconst The value of the derivative constant
+         * @param iLimit The largest magnitude of the integral, used with PidFeature::integralClamp
+         * @param oLimit The largest magnitude of the output, used with PidFeature::outputLimit
+         * @param alpha The weight of a new derivative sample, used with PidFeature::derivativeFilter.
+         *              1 means no filtering, smaller values filter more
+         */
+        PidController(T Pconst, T Iconst, T Dconst, T iLimit = 0, T oLimit = 0, T alpha = 1)
+            : kP(Pconst), kI(Iconst), kD(Dconst), integralLimit(iLimit), outLimit(oLimit),
+              filterAlpha(alpha) {
+            reset();
+        }
+        /**
+         * Clears the integral, derivative and previous error, to be called before
+         * starting a new move
+         */
+        void reset() {
+            integral = 0;
+            derivative = 0;
+            prevError = 0;
+            prevMeasurement = 0;
+            error = 0;
+            started = false;
+        }
+        /**
+         * Runs one iteration of the controller
+         * @param target The value the controller is trying to reach
+         * @param measurement The current measured value
+         * @return The output of the controller
+         */
+        T update(T target, T measurement) {
+            error = target - measurement;
+
+            if constexpr((Features & PidFeature::resetOnCross) != 0) {
+                if(started && ((error > 0 && prevError < 0) || (error < 0 && prevError > 0))) integral = 0;
+            }
+            integral += error;
+            if constexpr((Features & PidFeature::integralClamp) != 0) {
+                integral = clamp(integral, integralLimit);
+            }
+
+            T rawDerivative = 0;
+            if(started) {
+                if constexpr((Features & PidFeature::derivativeOnMeasurement) != 0) {
+                    rawDerivative = prevMeasurement - measurement;
+                }
+                else {
+                    rawDerivative = error - prevError;
+                }
+            }
+            if constexpr((Features & PidFeature::derivativeFilter) != 0) {
+                derivative += filterAlpha * (rawDerivative - derivative);
+            }
+            else {
+                derivative = rawDerivative;
+            }
+            prevError = error;
+            prevMeasurement = measurement;
+            started = true;
+
+            T output = (error * kP) + (integral * kI) + (derivative * kD);
+            if constexpr((Features & PidFeature::outputLimit) != 0) {
+                output = clamp(output, outLimit);
+            }
+            return output;
+        }
+        /**
+         * Changes the largest magnitude of the output. Used for ramping the
+         * output up at the start of a move
+         * @param limit The new output limit
+         */
+        void setOutputLimit(T limit) {
+            outLimit = limit;
+        }
+        /**
+         * Changes the PID constants
+         */
+        void setGains(T Pconst, T Iconst, T Dconst) {
+            kP = Pconst;
+            kI = Iconst;
+            kD = Dconst;
+        }
+        /**
+         * Functions to retrieve the state of the controller from the last update
+         */
+        T getError() const { return error; }
+        T getIntegral() const { return integral; }
+        T getDerivative() const { return derivative; }
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include "library.hpp"
+#include "Tasks.hpp"
+#include "TipGuard.hpp"
+/**
+ * The header file for the Pipeline namespace, which runs one tick of driver control in
+ * three stages:
+ * sense: every input is read once, into a SensorFrame, by the sensor task (see Tasks.hpp)
+ * plan: every subsystem works out its motor outputs from that frame alone, without
+ *       touching any devices. The drive's outputs are then shaped by the TipGuard (see
+ *       TipGuard.hpp), the one part that also carries the last tick's outputs over
+ * flush: all the outputs are written to the motors in one pass, each port once
+ *
+ * As plan() only depends on the frame (and the TipGuard's last outputs), a tick can be
+ * replayed exactly by feeding it the same frames again, and its cost can be measured apart
+ * from the device I/O.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+namespace Pipeline
+{
+    /**
+     * Works out every subsystem's outputs for one tick
+     * @param frame The inputs of the tick
+     * @param guard The TipGuard that shapes the drive's outputs. Driver control uses the
+     *              robot's tipGuard, and anything else (like a benchmark) uses its own, so
+     *              it doesn't change the last outputs the real one carries over
+     * @return The outputs to send to the motors
+     */
+    MotorOutputs plan(const Tasks::SensorFrame & frame, TipGuard & guard);
+    MotorOutputs plan(const Tasks::SensorFrame & frame);
+    /**
+     * Writes the outputs to the motors
+     * @param out The outputs from plan()
+     */
+    void flush(const MotorOutputs & out);
+    /**
+     * Runs one whole tick: plan(), then flush()
+     * @param frame The inputs of the tick
+     * @param guard The TipGuard to shape the drive's outputs with, as in plan()
+     */
+    void tick(const Tasks::SensorFrame & frame, TipGuard & guard);
+    void tick(const Tasks::SensorFrame & frame);
+}
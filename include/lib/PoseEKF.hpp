@@ -0,0 +1,130 @@
+#pragma once
+#include "api.h"
+#include "library.hpp"
+#include "TankDrive.hpp"
+#include "Tasks.hpp"
+#include "Matrix.hpp"
+#include "DoubleBuffer.hpp"
+#include <atomic>
+/**
+ * The header file for the PoseEKF class, an extended Kalman filter that estimates the
+ * robot's pose, speed and turn rate from the drive encoders and the IMU together.
+ *
+ * Odometry (see Odometry.hpp) only uses the encoders, so every bit of wheel slip ends up in
+ * the pose for good. The IMU doesn't slip, but its readings are noisy. The filter keeps an
+ * estimate of the state and how uncertain each part of it is, and every SensorFrame:
+ * - predicts the state forward to the frame's time, using the IMU's forward acceleration
+ * - corrects the speed with the encoders, and the turn rate with both the encoders and the
+ *   IMU's gyro, trusting each in proportion to how noisy it is
+ * A reading too far from the prediction to be noise (a wheel slipping, most often) is
+ * thrown out rather than used.
+ *
+ * The state is x and y (inches), the heading (radians, clockwise), the speed (inches per
+ * second, forwards) and the turn rate (radians per second, clockwise). Everything is
+ * stored in fixed size Matrix objects (see Matrix.hpp), so nothing is allocated on the heap.
+ *
+ * update() is run by the odometry task (see Tasks.hpp) after Odometry::update, and
+ * publishes the estimate through a DoubleBuffer, so any task can read it with getEstimate().
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class PoseEKF
+{
+    public:
+        //The number of values in the state, and where each one is
+        static constexpr int states = 5;
+        enum StateIndex { X = 0, Y, THETA, VEL, OMEGA };
+        /**
+         * What the filter publishes: the pose (in the same units as Odometry), the speed
+         * in inches per second, and the turn rate in degrees per second, clockwise
+         */
+        struct Estimate
+        {
+            Pose pose;
+            double velocity;
+            double turnRate;
+        };
+        /**
+         * How much the state is expected to change on its own, per second, as variances.
+         * The speed and turn rate change whenever the driver or a command changes the motor
+         * power, so they get most of it
+         */
+        static constexpr double positionNoise = 0.01;
+        static constexpr double headingNoise = 0.0001;
+        static constexpr double velocityNoise = 400;
+        static constexpr double turnRateNoise = 25;
+        /**
+         * How noisy each reading is, as a variance: the encoders' speed (inches per second)
+         * and turn rate (radians per second), which scrub and slip in turns, and the gyro's
+         * turn rate, which is trusted most
+         */
+        static constexpr double encoderVelocityNoise = 4;
+        static constexpr double encoderTurnRateNoise = 0.04;
+        static constexpr double gyroTurnRateNoise = 0.0004;
+        /**
+         * A reading is thrown out if it is further from the prediction than this many
+         * standard deviations
+         */
+        static constexpr double gate = 4;
+        /**
+         * The longest gap between frames that is predicted across, in seconds. A longer
+         * one (after the sensor task was held up) is treated as this long, so a single late
+         * frame can't throw the pose off
+         */
+        static constexpr double maxStep = 0.05;
+
+        /**
+         * The constructor for the PoseEKF class. The robot starts at {0, 0, 0}, standing still
+         * @param d The drivetrain the encoders belong to
+         */
+        PoseEKF(TankDrive & d);
+        /**
+         * Predicts the state forward to the frame's time and corrects it with the frame's
+         * readings. Only the odometry task may call this
+         * @param frame The latest SensorFrame from the sensor task
+         */
+        void update(const Tasks::SensorFrame & frame);
+        /**
+         * Sets the pose the robot is at, standing still. It takes effect at the next update
+         * @param start The pose to start from
+         */
+        void reset(Pose start = {0, 0, 0});
+        /**
+         * Return the latest estimate, or just its pose. Any task may call these
+         */
+        Estimate getEstimate();
+        Pose getPose();
+        /**
+         * Returns the number of readings thrown out as too far from the prediction
+         */
+        uint32_t getRejected();
+    private:
+        TankDrive & drive;
+        //The state and its covariance (how uncertain each part is, and how they are related)
+        Matrix<states, 1> x;
+        Matrix<states, states> P;
+        //The time of the last frame, in microseconds, or 0 before the first one
+        uint64_t lastTime;
+        DoubleBuffer<Estimate> published;
+        /**
+         * The pose asked for by reset(), which the odometry task picks up at its next update
+         */
+        Pose resetPose;
+        std::atomic<bool> resetRequested;
+        std::atomic<uint32_t> rejected;
+        /**
+         * Moves the state forward dt seconds, with the robot speeding up by accel inches
+         * per second squared
+         */
+        void predict(double dt, double accel);
+        /**
+         * Corrects the state with a reading z of the value at index i, with the given variance
+         */
+        void measure(int i, double z, double variance);
+        /**
+         * Puts the state back to the given pose, standing still and certain
+         */
+        void setState(Pose pose);
+};
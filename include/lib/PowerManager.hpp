@@ -0,0 +1,163 @@
+#pragma once
+#include "api.h"
+#include "library.hpp"
+#include "Tasks.hpp"
+#include "DoubleBuffer.hpp"
+#include <vector>
+/**
+ * The header file for the PowerManager class, which keeps track of the temperature
+ * and current draw of every motor on the robot and hands out a shared current budget
+ * between them.
+ *
+ * V5 motors cut their own power in steps once they pass 55 degrees C, which shows up as the
+ * intakes or conveyor suddenly slowing down in the middle of a match. The PowerManager
+ * instead lowers each motor's current limit gradually as it heats up, and gives the
+ * drivetrain first pick of the current budget while it is moving, so mechanisms are
+ * throttled a little early instead of cut a lot late.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class PowerManager
+{
+    public:
+        /**
+         * A struct holding the last readings and the current limit the PowerManager
+         * assigned to a single motor port
+         */
+        struct MotorStatus
+        {
+            int port;
+            double temp;
+            int current;
+            bool overTemp;
+            bool overCurrent;
+            int currentLimit;
+        };
+        /**
+         * The most motors the PowerManager publishes the status of, one per smart port
+         */
+        static constexpr int maxMotors = 21;
+    private:
+        /**
+         * A group of motors that belong to the same subsystem, along with the
+         * priority that subsystem has when the current budget is split up
+         */
+        struct MotorGroup
+        {
+            std::vector<int> ports;
+            PowerPriority priority;
+        };
+        /**
+         * The motor groups registered with addGroup() and the status of every
+         * motor in them. statuses is indexed in the same order as the ports were added
+         */
+        std::vector<MotorGroup> groups;
+        std::vector<MotorStatus> statuses;
+        /**
+         * Whether each motor's limit was below its current draw at the last update,
+         * indexed the same way as statuses
+         */
+        std::vector<bool> throttled;
+        /**
+         * A copy of statuses published after every update, so other tasks (like the GUI)
+         * can read it while the background task is writing statuses
+         */
+        struct StatusList
+        {
+            MotorStatus motors[maxMotors];
+            int count;
+        };
+        DoubleBuffer<StatusList> published;
+        /**
+         * The total current, in mA, that may be given out between all the motors
+         */
+        int budget;
+        /**
+         * The temperatures, in degrees C, between which a motor's current limit is
+         * lowered from its full value down to minThermalFactor of that value
+         */
+        double derateStartTemp, derateEndTemp;
+        /**
+         * The counts of updates in which a motor reported its over temperature or
+         * over current flag, and of times a motor's limit was cut below the current it was drawing
+         */
+        int overTempEvents, overCurrentEvents, throttleEvents;
+        /**
+         * The PROS task running update() in the background, and the time
+         * between its updates in milliseconds
+         */
+        pros::task_t task;
+        uint32_t period;
+        /**
+         * The function run by the background task. PROS tasks take a C function pointer,
+         * so the PowerManager passes itself in as the task parameter
+         */
+        static void taskFn(void * param);
+        /**
+         * Copies statuses into published
+         */
+        void publish();
+        /**
+         * Finds the thermal factor of a motor, a value between minThermalFactor and 1
+         * that its maximum current is multiplied by
+         * @param s The status of the motor
+         */
+        double thermalFactor(const MotorStatus & s);
+        /**
+         * Checks whether any motor in a group is currently being driven
+         * @param g The motor group to check
+         */
+        bool isActive(const MotorGroup & g);
+    public:
+        /**
+         * The maximum current a single V5 motor will draw, in mA
+         */
+        static constexpr int maxMotorCurrent = 2500;
+        /**
+         * The current, in mA, every motor keeps no matter how the budget is split,
+         * so no subsystem is ever stalled completely
+         */
+        static constexpr int floorCurrent = 300;
+        /**
+         * The lowest fraction of maxMotorCurrent a hot motor is allowed
+         */
+        static constexpr double minThermalFactor = 0.3;
+        /**
+         * How far, in mA, a new limit must be from the last one before it is written
+         * to the motor. This keeps the smart port link from being flooded with writes
+         */
+        static constexpr int limitHysteresis = 100;
+        /**
+         * The constructor for the PowerManager class
+         * @param totalBudget The total current, in mA, to split between all motors
+         * @param startTemp The temperature, in degrees C, at which current limits start being lowered
+         * @param endTemp The temperature, in degrees C, at which current limits reach their lowest value
+         */
+        PowerManager(int totalBudget, double startTemp = 45, double endTemp = 55);
+        /**
+         * Registers a group of motors with the PowerManager
+         * @param ports The ports of the motors in the group
+         * @param priority The priority of the group when splitting the current budget
+         */
+        void addGroup(const std::vector<int> & ports, PowerPriority priority);
+        /**
+         * Reads the temperature, current and flags of every motor and
+         * sets each motor's current limit from the budget
+         */
+        void update();
+        /**
+         * Starts a background task that calls update() every period milliseconds
+         * @param period The time between updates, in milliseconds
+         */
+        void start(uint32_t period = Tasks::power.period);
+        /**
+         * Functions to retrieve the status of every registered motor and the
+         * counts of over temperature, over current and throttle events
+         */
+        std::vector<MotorStatus> getStatuses();
+        int getOverTempEvents();
+        int getOverCurrentEvents();
+        int getThrottleEvents();
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include "library.hpp"
+#include "Command.hpp"
+/**
+ * The header file for the PreArm namespace, which gets the selected autonomous routine
+ * ready while the robot is disabled, so autonomous() can send its first motor commands
+ * as soon as the robot is enabled.
+ *
+ * run() is called from disabled() and competition_initialize(), which PROS ends when the
+ * robot is enabled. Whenever the selected routine changes, it:
+ * - starts the IMU calibrating, if initialize() couldn't (see Inertial.hpp)
+ * - zeroes the odometry and the PoseEKF, and puts the Localizer at the starting pose, as the robot is sitting at its starting position
+ * - simulates the routine (see AutonAnalyzer.hpp), which runs through every command's
+ *   code once so it is already in the cache, and gives the expected time
+ * - builds the routine's command graph in the CommandPool, or loads the recording for replay
+ *
+ * autonomous() then takes the routine with take() instead of building it, and records
+ * how long after it started the first tick of the routine had been sent.
+ *
+ * Once a competition autonomous has run, run() stops arming, so going through disabled
+ * between autonomous and driver control doesn't zero the odometry partway through a match.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+namespace PreArm
+{
+    /**
+     * What happened the last time a routine was armed and run
+     */
+    struct Stats
+    {
+        //The routine that was last armed
+        Auton id;
+        //How long arming took, in microseconds
+        uint32_t armUs;
+        //The simulated time of the armed routine, in milliseconds
+        uint32_t expectedMs;
+        //Whether the last autonomous used the armed routine instead of building its own
+        bool usedArmed;
+        //The time from the start of the last autonomous to the end of its first tick, in microseconds
+        uint32_t timeToMotionUs;
+    };
+    /**
+     * Arms the selected routine, and re-arms it whenever the selection changes, until
+     * the task calling it is ended. Only one task may call this at a time
+     */
+    void run();
+    /**
+     * Arms the selected routine once, unless something else holds the AutonAnalyzer's
+     * lock (see AutonAnalyzer.hpp), in which case it is left for the next try. The robot
+     * must be disabled
+     */
+    void arm();
+    /**
+     * Returns whether a routine is being armed right now. Any task may call this
+     */
+    bool isArming();
+    /**
+     * Cleans up after an arm() that PROS ended partway through, by freeing the lock and
+     * stopping the simulation it may have left running. It must only be called once the
+     * task that runs arm() has ended, so it is called through recoverAutonomous() (see externs.hpp)
+     */
+    void recover();
+    /**
+     * Returns the armed routine if it is the one asked for and is still in the
+     * CommandPool, or NULL if autonomous() has to build it itself. Either way, the
+     * routine is no longer armed afterwards. The caller must hold the AutonAnalyzer's lock
+     * @param id The routine autonomous() is about to run
+     */
+    Command * take(Auton id);
+    /**
+     * Records how long autonomous() took to send its first motor commands
+     * @param us The time from the start of autonomous() to the end of its first tick
+     */
+    void recordFirstMotion(uint32_t us);
+    Stats getStats();
+    /**
+     * Prints the stats to the terminal
+     */
+    void print();
+}
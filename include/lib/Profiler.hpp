@@ -0,0 +1,99 @@
+#pragma once
+#include "api.h"
+#include <atomic>
+/**
+ * The header file for the Profiler namespace and the PROFILE_SCOPE macro, which time how
+ * long a block of code takes every time it runs.
+ *
+ * Putting PROFILE_SCOPE("name") at the start of a block creates a probe with that name the
+ * first time the block runs, and records the time from that line to the end of the block
+ * every time after. Each probe keeps the count, minimum, maximum and mean time, and a
+ * histogram of times, using atomics, so probes can be hit from any task without a mutex and
+ * without printing anything. Profiler::print() prints every probe's summary on demand.
+ *
+ * The probes are only compiled in when ENABLE_PROFILING is defined, which the Makefile does
+ * when it is run with PROFILE=1 (make PROFILE=1). Otherwise PROFILE_SCOPE compiles to
+ * nothing, so probes can be left in the code without costing anything in competition.
+ *
+ * Times are measured with pros::micros(), so anything much shorter than a microsecond
+ * shows up as 0 or 1. The mean of many runs is still accurate to a fraction of a microsecond.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+namespace Profiler
+{
+    /**
+     * The number of histogram buckets. Bucket 0 counts times under 1 us, bucket i counts
+     * times from 2^(i-1) us up to 2^i us, and the last bucket counts everything longer
+     */
+    constexpr int buckets = 12;
+
+    class Probe
+    {
+        public:
+            const char * name;
+            std::atomic<uint32_t> count;
+            std::atomic<uint64_t> totalUs;
+            std::atomic<uint32_t> minUs;
+            std::atomic<uint32_t> maxUs;
+            std::atomic<uint32_t> histogram[buckets];
+            //The next probe in the list of every probe
+            Probe * next;
+            /**
+             * Creates a probe and adds it to the list of every probe
+             */
+            Probe(const char * probeName);
+            /**
+             * Records one run of the probe
+             * @param us The time the run took, in microseconds
+             */
+            void record(uint32_t us);
+            /**
+             * Clears everything recorded
+             */
+            void reset();
+    };
+
+    /**
+     * Times the block it is created in, and records the time in a probe when the block ends
+     */
+    class Scope
+    {
+        private:
+            Probe & probe;
+            uint32_t start;
+        public:
+            Scope(Probe & p) : probe(p), start(pros::c::micros()) {}
+            ~Scope() { probe.record((uint32_t)pros::c::micros() - start); }
+    };
+
+    /**
+     * Returns whether the probes were compiled in
+     */
+    bool isEnabled();
+    /**
+     * Prints the summary of every probe to the terminal
+     */
+    void print();
+    /**
+     * Clears every probe
+     */
+    void reset();
+    /**
+     * Returns the first probe in the list of every probe, or NULL if there are none.
+     * The rest are found through each probe's next pointer
+     */
+    Probe * first();
+}
+
+#ifdef ENABLE_PROFILING
+#define PROFILE_JOIN_(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN_(a, b)
+#define PROFILE_SCOPE(name) \
+    static Profiler::Probe PROFILE_JOIN(profileProbe, __LINE__)(name); \
+    Profiler::Scope PROFILE_JOIN(profileScope, __LINE__)(PROFILE_JOIN(profileProbe, __LINE__))
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
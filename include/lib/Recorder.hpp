@@ -0,0 +1,132 @@
+#pragma once
+#include "api.h"
+#include "library.hpp"
+#include <atomic>
+/**
+ * The header file for the Recorder class, which records the controller during driver
+ * control and plays the recording back as an autonomous routine.
+ *
+ * Every driver control tick, the ControllerState (defined in library.hpp) is stored in a
+ * fixed size array. Once the recording is finished, it is written to the microSD card in one
+ * go by flush(), which the low priority logging task calls (see Tasks.hpp), so recording
+ * never slows down the driver control loop. Replaying feeds each recorded
+ * state back through the same driverTick() function driver control uses, at the same tick period,
+ * so the robot does what it did when the recording was made.
+ *
+ * The file format is a 12 byte header (the characters "RPL1", then the tick period in ms and
+ * the number of frames as little-endian 32 bit integers), followed by one 6 byte frame per tick:
+ * the four joystick axes as signed bytes, then the button bitmask as a little-endian 16 bit integer.
+ * tools/replay_dump.py prints a recording as CSV on a computer.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class Recorder
+{
+    private:
+        /**
+         * The most frames that can be stored, enough for a 60 second skills run at 20 ms
+         */
+        static constexpr int maxFrames = 3000;
+        /**
+         * The recorded frames, and the number of frames recorded or loaded
+         */
+        ControllerState frames[maxFrames];
+        int frameCount;
+        /**
+         * The number of frames to record before saving, 0 when not recording
+         */
+        int framesToRecord;
+        /**
+         * The path of the recording file on the microSD card
+         */
+        const char * path;
+        /**
+         * The time between frames, in milliseconds
+         */
+        uint32_t period;
+        /**
+         * Set by stopReplay() from another task, and checked by replay() each frame
+         */
+        std::atomic<bool> stopRequested;
+        /**
+         * Set by preload() once the recording file is in frames, so the next replay()
+         * can start straight away
+         */
+        std::atomic<bool> preloaded;
+        /**
+         * Set once a recording is finished and waiting for flush() to write it, and while
+         * flush() is writing it, so arm() doesn't start recording over the frames being written
+         */
+        std::atomic<bool> savePending, saving;
+        /**
+         * Loads the recording file into frames
+         * @return true if a valid recording was loaded
+         */
+        bool load();
+    public:
+        /**
+         * The constructor for the Recorder class
+         * @param file The path of the recording file, which should start with /usd/
+         * @param tickPeriod The time between frames, in milliseconds. Must match the control task's period
+         */
+        Recorder(const char * file, uint32_t tickPeriod);
+        /**
+         * Starts a new recording. The recording begins with the next call to record().
+         * A finished recording that hasn't been written yet is thrown away, and one being
+         * written is waited for
+         * @param duration How long to record for, in milliseconds. Defaults to the length of autonomous
+         */
+        void arm(uint32_t duration = 15000);
+        /**
+         * Stops a recording early, and has flush() save what was recorded
+         */
+        void disarm();
+        /**
+         * Returns whether a recording is in progress
+         */
+        bool isArmed();
+        /**
+         * Adds a frame to the recording, if one is in progress. The recording is handed
+         * to flush() to be saved once it reaches the length passed to arm()
+         * @param input The controller state of this tick
+         */
+        void record(const ControllerState & input);
+        /**
+         * Saves a finished recording, if there is one waiting. Writing to the microSD card
+         * can take hundreds of milliseconds, so this must only be called from a low priority
+         * task, never from the control task
+         */
+        void flush();
+        /**
+         * Writes the recorded frames to the microSD card
+         * @return true if the file was written
+         */
+        bool save();
+        /**
+         * Plays back the recording file, calling tick with each frame at the recorded period
+         * @param tick The function that runs one tick of driver control
+         * @return true if a recording was found and played
+         */
+        bool replay(void (*tick)(const ControllerState &));
+        /**
+         * Loads the recording file ahead of time, so the next replay() doesn't have to
+         * wait on the microSD card. Starting a new recording throws the loaded one away
+         * @return true if a valid recording was loaded
+         */
+        bool preload();
+        /**
+         * Asks a replay in progress to stop at its next frame. Safe to call from any task.
+         * A request made while nothing is replaying is dropped when the next replay starts
+         */
+        void stopReplay();
+        /**
+         * Returns the time between frames, in milliseconds
+         */
+        uint32_t getPeriod();
+        /**
+         * Returns the number of frames recorded or loaded
+         */
+        int getFrameCount();
+};
@@ -0,0 +1,180 @@
+#pragma once
+#include "Command.hpp"
+#include "TankDrive.hpp"
+#include "intake.hpp"
+#include "Conveyor.hpp"
+#include "Indexer.hpp"
+/**
+ * The header file for the commands that run the robot's subsystems. They are built on
+ * the command framework in Command.hpp, and are used to write autonomous routines.
+ * While the Timeline is simulating, none of them move a motor: drive moves and scoring
+ * finish after an estimated time instead, and everything else just finishes.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+
+/**
+ * Drives straight or turns using TankDrive's startStraight/startTurn and updateMove.
+ * Once the move is done, the drivetrain is stopped and the command waits a short
+ * time for the robot to come to rest, the same as moveStraight and turnAngle do
+ */
+class DriveCommand : public Command
+{
+    private:
+        TankDrive & drive;
+        //Whether the move is a turn, and the distance (inches) or angle (degrees) to move
+        bool turn;
+        double amount;
+        //The time to wait after the move, in milliseconds
+        uint32_t settle;
+        //Whether the brain or the motors run the position loop (see library.hpp)
+        MoveMode mode;
+        //Whether the move is done, and when it finished
+        bool done;
+        uint32_t doneTime;
+        //When a simulated move finishes (see Timeline.hpp)
+        uint32_t simEnd;
+    public:
+        DriveCommand(TankDrive & d, bool isTurn, double amt, uint32_t settleTime = 200,
+                     MoveMode moveMode = MoveMode::brain);
+        void initialize() override;
+        void execute() override;
+        bool isFinished() override;
+        void end(bool interrupted) override;
+        const char * getName() override {
+            if(mode == MoveMode::onboard) return turn ? "turn onboard" : "straight onboard";
+            return turn ? "turn" : "straight";
+        }
+};
+
+/**
+ * Drives to a point or a pose on the field in one curved move, using TankDrive's
+ * startMoveTo and updateMoveTo with the odometry's pose. The target is in field
+ * coordinates (see Localizer.hpp), so a route can be written as the places the robot
+ * goes to rather than the turns and straights between them. A chained move (one with
+ * an exit radius) finishes while the robot is still moving. If the next command in its
+ * sequence is a drive move, the motors are left running, so that move carries on
+ * without stopping. Otherwise they are stopped as the move ends
+ */
+class MoveToCommand : public Command
+{
+    private:
+        TankDrive & drive;
+        //The target on the field, and whether its heading is used
+        Pose target;
+        bool useHeading;
+        //Whether the robot drives backwards to the target
+        bool reverse;
+        //The distance from the target at which a chained move finishes, or 0 to stop on it
+        double exitRadius;
+        //The time to wait after the move, in milliseconds
+        uint32_t settle;
+        //Whether the move is done, and when it finished
+        bool done;
+        uint32_t doneTime;
+        //When a simulated move finishes (see Timeline.hpp)
+        uint32_t simEnd;
+    public:
+        MoveToCommand(TankDrive & d, Pose fieldTarget, bool heading, bool backwards = false,
+                      double exit = 0, uint32_t settleTime = 200);
+        void initialize() override;
+        void execute() override;
+        bool isFinished() override;
+        void end(bool interrupted) override;
+        const char * getName() override { return useHeading ? "moveToPose" : "moveToPoint"; }
+};
+
+/**
+ * Sets the intake to take in (1), push out (-1) or stop (0). If hold is false the
+ * command finishes straight away and leaves the intake running. If hold is true
+ * the command keeps running until it is interrupted, then stops the intake, which
+ * is how an intake is run for exactly as long as another command in a race or deadline
+ */
+class IntakeCommand : public Command
+{
+    private:
+        Intake & intake;
+        int direction;
+        bool hold;
+    public:
+        IntakeCommand(Intake & in, int dir, bool holdUntilInterrupted);
+        void initialize() override;
+        bool isFinished() override;
+        void end(bool interrupted) override;
+        const char * getName() override { return "intake"; }
+};
+
+/**
+ * The same as IntakeCommand, but for the conveyor: up (1), down (-1) or stop (0)
+ */
+class ConveyorCommand : public Command
+{
+    private:
+        Conveyor & conveyor;
+        int direction;
+        bool hold;
+    public:
+        ConveyorCommand(Conveyor & conv, int dir, bool holdUntilInterrupted);
+        void initialize() override;
+        bool isFinished() override;
+        void end(bool interrupted) override;
+        const char * getName() override { return "conveyor"; }
+};
+
+/**
+ * Puts the indexer into its intaking state and finishes straight away
+ */
+class IndexerIntakeCommand : public Command
+{
+    private:
+        Indexer & indexer;
+    public:
+        IndexerIntakeCommand(Indexer & idx);
+        void initialize() override;
+        const char * getName() override { return "indexerIntake"; }
+};
+
+/**
+ * Shoots balls with the indexer and finishes as soon as they have all left the
+ * conveyor, or the timeout runs out
+ */
+class IndexerScoreCommand : public Command
+{
+    private:
+        Indexer & indexer;
+        int balls;
+        uint32_t timeout;
+        //When a simulated score finishes (see Timeline.hpp)
+        uint32_t simEnd;
+    public:
+        IndexerScoreCommand(Indexer & idx, int numBalls, uint32_t ms);
+        void initialize() override;
+        bool isFinished() override;
+        void end(bool interrupted) override;
+        const char * getName() override { return "score"; }
+};
+
+namespace Commands
+{
+    /**
+     * Short functions for creating the commands above in the CommandPool
+     */
+    Command * straight(TankDrive & drive, double distance, MoveMode mode = MoveMode::brain);
+    Command * turn(TankDrive & drive, double angle, MoveMode mode = MoveMode::brain);
+    /**
+     * Drive to (x, y) on the field, in inches, and for moveToPose finish facing theta
+     * (degrees, clockwise from facing away from the driver station). Give an exitRadius to
+     * chain into the next move
+     */
+    Command * moveToPoint(TankDrive & drive, double x, double y, bool reverse = false, double exitRadius = 0);
+    Command * moveToPose(TankDrive & drive, double x, double y, double theta, bool reverse = false,
+                         double exitRadius = 0);
+    Command * setIntake(Intake & intake, int direction);
+    Command * runIntake(Intake & intake, int direction);
+    Command * setConveyor(Conveyor & conveyor, int direction);
+    Command * runConveyor(Conveyor & conveyor, int direction);
+    Command * indexerIntake(Indexer & indexer);
+    Command * score(Indexer & indexer, int balls, uint32_t timeout = 3000);
+}
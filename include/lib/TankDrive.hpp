@@ -1,5 +1,9 @@
 #pragma once
 #include "library.hpp"
+#include "PidController.hpp"
+#include "DoubleBuffer.hpp"
+#include "TractionControl.hpp"
+#include <atomic>
 #include <vector>
 #include <initializer_list>
 /**
@@ -13,6 +17,26 @@
 
 class TankDrive 
 {
+    public:
+        /**
+         * The position and velocity of one side of the drive, fused from every
+         * encoder on that side (see updateEncoders), and how many of its encoders
+         * gave a reading the last time
+         */ 
+        struct SideState
+        {
+            //In degrees, starting from 0 when the program starts
+            double position;
+            //In rpm
+            double velocity;
+            int healthy;
+        };
+        /**
+         * How far apart, in degrees per update and rpm, the encoders on one side can
+         * be before the ones furthest from the rest are thrown out
+         */ 
+        static constexpr double positionTolerance = 10;
+        static constexpr double velocityTolerance = 20;
     private:
         /**
          * Vectors of ints that store the motor ports for each side of the 
@@ -21,7 +45,9 @@ class TankDrive
         std::vector<int> leftMotorPorts, rightMotorPorts;
 
         /**
-         * Variable to store the diameter of the wheel
+         * Variable to store the effective diameter of the wheel: the distance the robot
+         * travels per motor rotation, over pi. It includes any gearing between the motors
+         * and the wheels, and is measured by Calibration (see Calibration.hpp)
          * This value is used to convert values passed in for
          * autonomous functions from inches to degrees to rotate for
          */ 
@@ -32,10 +58,23 @@ class TankDrive
          * 
          * As long as the robot's base is rectangular, the turning point of the robot will always
          * be down the robot's front-facing middle. So, this value will be usable no matter
-         * the wheel configuration
+         * the wheel configuration. Wheels scrub sideways in a turn, so the width measured by
+         * Calibration is a little different from the width measured with a ruler
          */ 
         double baseWidth;
 
+        /**
+         * The conversions worked out from the values above whenever they change, so the
+         * moves and the odometry only multiply: motor degrees per inch travelled, and
+         * inches each side travels per degree the robot turns
+         */ 
+        double degreesPerInch, turnInchesPerDegree;
+
+        /**
+         * The top speed of the drive motors in rpm, from the gearset passed into the constructor
+         */ 
+        int maxRpm;
+
         /**
          * Structs of type Telemetry (defined in externs.hpp) that hold the telemetry values for
          * each side of the drive
@@ -54,7 +93,88 @@ class TankDrive
          * @param rightTarg: The target length to move to, in inches, for the right side of the drivetrain
          *           Can be negative to indicate rotating backwards
          */
-        void drivePID(double leftTarg, double rightTarg); 
+        void drivePID(double leftTarg, double rightTarg, MoveMode mode = MoveMode::brain); 
+        /**
+         * Starts a move for drivePID (or a command) without running it. The targets are
+         * converted to degrees from the current positions and the PID controllers are reset.
+         * In onboard mode the targets are sent to the motors straight away
+         * 
+         * @param leftTarg: The target length to move to, in inches, for the left side of the drivetrain
+         * @param rightTarg: The target length to move to, in inches, for the right side of the drivetrain
+         * @param mode: Whether the brain or the motors run the position loop
+         */ 
+        void startMove(double leftTarg, double rightTarg, MoveMode mode = MoveMode::brain);
+        /**
+         * Runs one 20 ms update of an onboard move, raising the speed limit of each side
+         * and checking whether the move is done
+         * @return true once both sides have stopped at their targets, or the robot is stuck
+         */ 
+        bool updateOnboardMove();
+        /**
+         * The state of the move in progress: the targets, current positions and errors
+         * of each side in degrees, the current output cap in mV, and the number of
+         * updates in a row in which neither side has moved
+         */ 
+        double leftTarg, rightTarg, leftPos, rightPos, leftError, rightError, voltCap;
+        short int stuckCount;
+        /**
+         * The mode of the move in progress. For onboard moves, the distance each side
+         * has to travel in degrees, and the current speed limit in rpm
+         */ 
+        MoveMode moveMode;
+        double leftDistance, rightDistance, speedCap;
+        /**
+         * The state of the pose move in progress (see startMoveTo): the target, whether
+         * its heading is used, whether the robot drives backwards, how far ahead the carrot
+         * leads, the radius at which a chained move hands over, the output limit in mV,
+         * and the forward output of the last update in mV before any traction cut, which is slewed
+         */
+        Pose poseTarget;
+        bool poseUseHeading, poseReverse;
+        double poseLead, poseExitRadius, poseMaxVolt, poseLinear;
+        /**
+         * Watches for the wheels slipping during a move (see TractionControl.hpp), and the
+         * time of its last update in microseconds, or 0 at the start of a move
+         */
+        TractionControl traction;
+        uint64_t lastTractionTime;
+        /**
+         * Checks the wheels against the IMU readings in the latest SensorFrame
+         * @return The fraction of the output to send to the motors
+         */
+        double updateTraction();
+        /**
+         * What the fusion remembers about each encoder on a side: its reading at the
+         * last update and whether that reading was valid, along with the side's fused
+         * position so far. Only the task calling updateEncoders uses these
+         */ 
+        struct EncoderFusion
+        {
+            std::vector<double> last;
+            std::vector<bool> lastValid;
+            double position;
+        };
+        EncoderFusion leftFusion, rightFusion;
+        /**
+         * Updates one side's fusion from its encoders
+         */ 
+        SideState fuse(const std::vector<int> & ports, EncoderFusion & fusion);
+        /**
+         * The latest fused state of both sides, published for every other task
+         */ 
+        struct Sides
+        {
+            SideState left, right;
+        };
+        DoubleBuffer<Sides> sides;
+        //The number of encoder readings thrown out as outliers
+        std::atomic<uint32_t> rejectedReadings;
+        /**
+         * The position PID constants given to the motors for onboard moves, and
+         * whether any were set. The motors' own defaults are used until they are
+         */ 
+        pros::motor_pid_s_t onboardPid;
+        bool onboardPidSet;
 
         /**
          * Functions to update the telemetry data for each motor group of the
@@ -64,10 +184,10 @@ class TankDrive
         void updateRightTelemetry();
 
         /**
-         * The PID constant values, kP for the proportional constant,
-         * kI for the integral constant, and kD for the derivative constant
+         * The PID controllers for each side of the drivetrain, built from the
+         * PID constants passed into the constructor. They are defined in PidController.hpp
          */ 
-        double kP, kI, kD;
+        PidController<double> leftPID, rightPID;
     public:
         /**
          * The constructor for the TankDrive Class
@@ -80,8 +200,8 @@ class TankDrive
          * match to the port numbers in the corresponding indeces in leftPorts/rightPorts
          * @param gearset: the motor gearset used in the motors (it is assumed that both 
          *                 motors use the same gearset)
-         * @param wD: the diameter of the wheels used
-         * @param bW: the distance from the middle of the robot to the wheels
+         * @param wD: the effective diameter of the wheels used (see wheelDiameter above)
+         * @param bW: the distance between the wheels on each side
          * @param Pconst: the value of the proportional constant in the PID controller
          * @param Iconst: the value of the integral constant in the PID controller
          * @param Dconst: the value of the derivative constant in the PID controller
@@ -98,6 +218,25 @@ class TankDrive
          * @param controller the ID of the controller to get joystick values from
          */ 
         void driver(pros::controller_id_e_t controller);
+        /**
+         * The same as driver(), but using a ControllerState (defined in library.hpp) that
+         * has already been read, either from the controller or from a recording
+         * 
+         * @param input the controller state to get joystick values from
+         */ 
+        void driver(const ControllerState & input);
+        /**
+         * Works out what driver() would send to the motors, without sending it. It only
+         * depends on input, so it gives the same result every time for the same input
+         * 
+         * @param input the controller state to get joystick values from
+         * @param out the outputs to fill in the drive's part of (see library.hpp)
+         */ 
+        void plan(const ControllerState & input, MotorOutputs & out) const;
+        /**
+         * Sets the power of each side of the drive, from -127 to 127
+         */ 
+        void setPower(int leftPower, int rightPower);
 
         /**
          * The setVelocity function manually sets the velocity of each motor group. This really
@@ -120,15 +259,152 @@ class TankDrive
          *        is negative. For example, passing in 45 would make the robot turn
          *        45 degrees to the right (clockwise, from an overhead view)
          */ 
-        void turnAngle(double angle); 
+        void turnAngle(double angle, MoveMode mode = MoveMode::brain); 
 
         /**
          * The moveStraight function is an autonomous function used to
          * tell the robot to drive forward or backward a given amount
          * 
          * @param distance: the distance to travel, in inches. Negative values = backwards
+         * @param mode: Whether the brain or the motors run the position loop (see library.hpp)
+         */
+        void moveStraight(double distance, MoveMode mode = MoveMode::brain); 
+        /**
+         * startStraight and startTurn start the same moves as moveStraight and turnAngle,
+         * but return straight away. The move is then run by calling updateMove every 20 ms
+         * until it returns true, then calling endMove. This lets the command scheduler
+         * run other subsystems while the drivetrain moves
+         * 
+         * @param distance: the distance to travel, in inches. Negative values = backwards
+         * @param angle: the angle to turn, in degrees. Clockwise is positive
+         * @param mode: Whether the brain or the motors run the position loop (see library.hpp)
+         */ 
+        void startStraight(double distance, MoveMode mode = MoveMode::brain);
+        void startTurn(double angle, MoveMode mode = MoveMode::brain);
+        /**
+         * Returns the distance each side of the base travels to turn the given angle
+         * 
+         * @param angle: the angle to turn, in degrees. Clockwise is positive
+         */ 
+        double getTurnLength(double angle);
+        /**
+         * Convert between inches travelled by a side of the base and degrees turned by
+         * its wheels, using the same conversion as the moves
+         */ 
+        double inchesToDegrees(double inches);
+        double degreesToInches(double degrees);
+        /**
+         * Returns the width of the base, in inches
+         */ 
+        double getBaseWidth();
+        /**
+         * Returns the effective wheel diameter, in inches
+         */ 
+        double getWheelDiameter();
+        /**
+         * Returns the top speed of the motors' gearset, in rpm
+         */ 
+        int getMaxRpm();
+        /**
+         * Replaces the geometry passed into the constructor, with values measured by Calibration
+         * @param wD: the effective diameter of the wheels, in inches
+         * @param bW: the effective width of the base, in inches
+         */ 
+        void setGeometry(double wD, double bW);
+        /**
+         * Reads every encoder on the drive once and updates each side's fused position
+         * and velocity. It is called by the sensor task every update, so other code
+         * never reads the encoders itself. Only one task may call this
+         */ 
+        void updateEncoders();
+        /**
+         * Return the fused state of each side from the last updateEncoders(). Any task may call these
+         */ 
+        SideState getLeftState();
+        SideState getRightState();
+        /**
+         * Return the fused position of each side, in degrees. The encoders are never
+         * tared, so these only change when the wheels turn
+         */ 
+        double getLeftPosition();
+        double getRightPosition();
+        /**
+         * Returns the number of encoder readings thrown out as outliers so far
+         */ 
+        uint32_t getRejectedReadings();
+        /**
+         * Returns the number of times the wheels have slipped during a move
+         */ 
+        uint32_t getSlipEvents();
+        /**
+         * Sets the position PID constants the motors use in onboard moves. They are
+         * scaled the same way as motor_convert_pid's. The motors' defaults are used
+         * until this is called
+         */ 
+        void setOnboardPid(double kf, double kp, double ki, double kd);
+        /**
+         * Runs one 20 ms update of the move started with startStraight or startTurn
+         * @return true once the move has reached its target or the robot is stuck
+         */ 
+        bool updateMove();
+        /**
+         * Stops the drivetrain at the end of a move
+         */ 
+        void endMove();
+
+        /**
+         * The gains of the pose moves: the forward output in mV per inch from the target,
+         * and the turning output in mV per degree off course. The forward output is slewed
+         * by poseSlew mV each update, so the robot doesn't wheelie or slip pulling away
+         */ 
+        static constexpr double poseLinearGain = 600;
+        static constexpr double poseAngularGain = 150;
+        static constexpr double poseSlew = 1200;
+        /**
+         * Within poseSettleRadius inches of the target, the robot stops steering towards it
+         * (the direction to a point that close swings around too fast to follow) and turns
+         * to the target heading instead, if there is one. A move is done within
+         * poseExitDistance inches, and poseExitAngle degrees of the target heading
+         */ 
+        static constexpr double poseSettleRadius = 6;
+        static constexpr double poseExitDistance = 1;
+        static constexpr double poseExitAngle = 3;
+        /**
+         * Outside poseSettleRadius, a move gives up as stuck once both sides have barely
+         * turned for this many updates in a row (500 ms), which is long enough to pull away
          */
-        void moveStraight(double distance); 
+        static constexpr int poseStuckUpdates = 25;
+        /**
+         * startMoveTo starts a move to a pose, given in the same frame as the pose that
+         * will be passed to updateMoveTo (the odometry's). The move is then run by calling
+         * updateMoveTo every 20 ms until it returns true, then calling endMove, the same as
+         * startStraight. The robot drives one curve to the target rather than turning and
+         * then driving straight
+         * 
+         * With useHeading, the robot steers towards a carrot point behind the target, along
+         * the target heading, which slides onto the target as the robot closes in, so it
+         * arrives facing the target heading (a "boomerang" move). Without it, the robot
+         * steers straight at the target and finishes facing whichever way it arrived
+         * 
+         * @param target: the pose to drive to. Its heading is only used with useHeading
+         * @param useHeading: whether the robot must finish at the target heading
+         * @param reverse: whether the robot drives backwards to the target
+         * @param lead: how far behind the target the carrot starts, as a fraction of the
+         *        distance to the target. Larger values swing wider
+         * @param exitRadius: if more than 0, the move is done as soon as the robot is this
+         *        many inches from the target and endMove shouldn't be called, so the next move
+         *        carries on at speed instead of stopping
+         * @param maxVolt: the largest output to either side, in mV
+         */ 
+        void startMoveTo(Pose target, bool useHeading, bool reverse = false, double lead = 0.6,
+                         double exitRadius = 0, double maxVolt = 12000);
+        /**
+         * Runs one 20 ms update of the move started with startMoveTo
+         * @param current: where the robot is now
+         * @return true once the robot has reached the target (or, for a chained move, is
+         *         within the exit radius), or is stuck
+         */ 
+        bool updateMoveTo(Pose current);
 
         /**
          * getLeftTelemetry() returns a struct containing motor telemetry values for the left
@@ -148,4 +424,10 @@ class TankDrive
          * @return The Telemetry values of the rightBase motor group
          */ 
         Telemetry getRightTelemetry();
+        /**
+         * getMotorPorts() returns the ports of every motor in the drivetrain, left side
+         * first, so other objects (like the PowerManager) can monitor them
+         * @return A vector of the ports of all drivetrain motors
+         */ 
+        std::vector<int> getMotorPorts();
 };
\ No newline at end of file
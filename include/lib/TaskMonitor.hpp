@@ -0,0 +1,94 @@
+#pragma once
+#include "api.h"
+/**
+ * The header file for the TaskMonitor namespace, which measures how much of the CPU each
+ * of the robot's tasks uses, how much of its stack it has ever used, and how much of the
+ * heap is in use, so task priorities and stack sizes can be chosen from data.
+ *
+ * PROS doesn't give access to FreeRTOS's own per-task statistics, so tasks register
+ * themselves with add() when they start, and wrap the work of each loop in beginWork()
+ * and endWork(). The CPU use of a task is the time it spent between those calls, as a
+ * fraction of the time since the last sample. Tasks that aren't ours, like the LVGL and
+ * PROS system tasks, can't be measured.
+ *
+ * The stack use is found the same way FreeRTOS finds it: a new task's stack is filled
+ * with the byte 0xa5, so the lowest byte that isn't 0xa5 anymore is the deepest the stack
+ * has been. If the stack wasn't filled, the stack use is reported as unknown.
+ *
+ * The samples are taken by the logging task (see Tasks.hpp).
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+namespace TaskMonitor
+{
+    /**
+     * The measurements for one task
+     */
+    struct TaskStats
+    {
+        const char * name;
+        //The task's CPU use over the last sample, from 0 to 100 percent
+        double cpu;
+        //The longest a single loop of the task has taken, in microseconds
+        uint32_t maxWorkUs;
+        //The size of the stack and the most of it ever used, in bytes
+        uint32_t stackBytes;
+        uint32_t stackUsed;
+        //false if the stack wasn't filled when the task started, so stackUsed is unknown
+        bool stackKnown;
+    };
+    /**
+     * The heap use of the program (newlib's malloc, used by new and std::vector) and
+     * of LVGL's memory pool, in bytes. PROS builds LVGL to allocate from the kernel's
+     * heap instead of its own pool, in which case the LVGL values are all 0
+     */
+    struct HeapStats
+    {
+        uint32_t heapTotal;
+        uint32_t heapUsed;
+        uint32_t heapFree;
+        uint32_t lvglTotal;
+        uint32_t lvglUsed;
+        uint8_t lvglFragPct;
+    };
+    /**
+     * The most tasks that can be registered
+     */
+    constexpr int maxTasks = 12;
+    /**
+     * Registers the task that calls it. Must be called from the very start of the task's
+     * function, as it uses the current stack position to find the stack. Registering a
+     * name again (like autonomous, which restarts whenever the robot is enabled) reuses
+     * the old entry
+     * @param name The name of the task
+     * @param stackDepth The stack size the task was created with, in 4 byte words
+     * (the same as task_create's stack_depth)
+     * @return The task's id, passed to beginWork and endWork, or -1 if too many tasks are registered
+     */
+    int add(const char * name, uint32_t stackDepth = TASK_STACK_DEPTH_DEFAULT);
+    /**
+     * Marks the start and end of one loop of a task's work
+     * @param id The id returned by add()
+     */
+    void beginWork(int id);
+    void endWork(int id);
+    /**
+     * Updates the CPU use of every task from the work recorded since the last sample,
+     * and checks every task's stack. Only one task (the logging task) may call this
+     */
+    void sample();
+    /**
+     * Copies the measurements from the last sample. Any task may call this
+     * @param out The array to copy to
+     * @param max The size of the array
+     * @return The number of tasks copied
+     */
+    int getTaskStats(TaskStats * out, int max);
+    HeapStats getHeapStats();
+    /**
+     * Prints the measurements from the last sample to the terminal
+     */
+    void print();
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include "api.h"
+#include "library.hpp"
+/**
+ * The header file for the Tasks namespace, which lays out every task the robot runs: its
+ * name, priority, stack size and period, all in one table, so the whole topology can be
+ * read and changed in one place.
+ *
+ * From highest priority to lowest:
+ * control: runs driver control (a Pipeline tick, or nothing during autonomous) at a
+ *          fixed rate. Autonomous raises its own task to this priority too
+ * sensors: reads the controller, the drive encoders (see TankDrive::updateEncoders), the
+ *          IMU and the Indexer's state into a SensorFrame
+ * odometry: turns each SensorFrame into a new pose (see Odometry.hpp and PoseEKF.hpp)
+ * colorSorter, indexer, power: the subsystem tasks (see ColorSorter.hpp, Indexer.hpp and
+ *          PowerManager.hpp), which take their settings from this table
+ * jams: watches the Intake and Conveyor for jammed balls and clears them (see
+ *          JamDetector.hpp), alongside the subsystem tasks that drive them
+ * localizer: corrects the odometry from the Distance sensors (see Localizer.hpp). A step
+ *          takes a few milliseconds, so it runs much less often than the odometry, and
+ *          below the subsystem tasks so it never holds them up
+ * logging: saves a finished recording to the microSD card (see Recorder.hpp), samples
+ *          the TaskMonitor and prints it, the control timing, the pose, the
+ *          ColorSorter's latency report and the counts of slips, tips and jams
+ * GUI: LVGL runs in PROS's own display task, below all of these. Its lv_tasks only read
+ *          values other tasks have published, so they never hold up anything else
+ *
+ * Data moves from task to task through DoubleBuffers (see DoubleBuffer.hpp) and atomics,
+ * so a low priority reader never blocks a high priority writer, and the control task's
+ * timing doesn't depend on what the GUI or the logger are doing.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+namespace Tasks
+{
+    /**
+     * The settings for one task
+     */
+    struct Config
+    {
+        const char * name;
+        uint32_t priority;
+        //The stack size, in 4 byte words, as passed to task_create
+        uint16_t stackDepth;
+        //The time between runs of the task's loop, in milliseconds
+        uint32_t period;
+    };
+    /**
+     * The control period must match the Recorder's tick period, so a recording
+     * replays at the speed it was made
+     */
+    constexpr Config control = {"Control", TASK_PRIORITY_DEFAULT + 4, TASK_STACK_DEPTH_DEFAULT, 20};
+    constexpr Config sensors = {"Sensors", TASK_PRIORITY_DEFAULT + 3, TASK_STACK_DEPTH_DEFAULT, 10};
+    constexpr Config odometry = {"Odometry", TASK_PRIORITY_DEFAULT + 2, TASK_STACK_DEPTH_DEFAULT, 10};
+    constexpr Config colorSorter = {"Color Sorter", TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, 5};
+    constexpr Config indexer = {"Indexer", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, 10};
+    constexpr Config power = {"Power Manager", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, 20};
+    constexpr Config jams = {"Jam Detector", TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, 20};
+    constexpr Config localizer = {"Localizer", TASK_PRIORITY_DEFAULT - 1, TASK_STACK_DEPTH_DEFAULT, 50};
+    constexpr Config logging = {"Logging", TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, 1000};
+
+    /**
+     * Everything the sensor task reads in one run, in the units it was read in
+     */
+    struct SensorFrame
+    {
+        ControllerState controller;
+        //The fused positions (degrees) and velocities (rpm) of the left and right sides of the drive
+        double leftPos;
+        double rightPos;
+        double leftVel;
+        double rightVel;
+        /**
+         * The IMU's turn rate (degrees per second, clockwise) and forward acceleration (g),
+         * or PROS_ERR_F while it isn't ready (see Inertial.hpp)
+         */
+        double yawRate;
+        double forwardAccel;
+        //The robot's pitch (positive with the nose up) and roll, in degrees (see Inertial.hpp), or PROS_ERR_F while the IMU isn't ready
+        double pitch;
+        double roll;
+        //The state of the Indexer, which decides whether the driver has the intake and conveyor
+        IndexerState indexer;
+        //The time the frame was read, in microseconds since the program started
+        uint64_t time;
+    };
+    /**
+     * How well the control task has kept to its period since it started
+     */
+    struct ControlStats
+    {
+        //The number of times the control loop has run
+        uint32_t ticks;
+        /**
+         * How far the time between the last two runs of the loop was from the period,
+         * and the furthest it has ever been, in microseconds
+         */
+        uint32_t lastJitterUs;
+        uint32_t maxJitterUs;
+        //The longest a single run of the loop has taken, in microseconds
+        uint32_t maxWorkUs;
+        //The number of runs that took longer than the whole period
+        uint32_t overruns;
+    };
+
+    /**
+     * Creates the control, sensor, odometry, jam, localizer and logging tasks. Calling it again does nothing
+     */
+    void start();
+    /**
+     * Turns driver control in the control task on or off. opcontrol() turns it on,
+     * and autonomous() and disabled() turn it off
+     */
+    void setDriverControl(bool enabled);
+    bool isDriverControl();
+    /**
+     * Only one thing at a time may drive the robot in place of driver control: an
+     * autonomous routine (from the competition or the GUI), the move mode comparison, or
+     * the drive calibration's turns. Each claims the robot for as long as it runs, and
+     * only pauses driver control and hands it back while it holds the claim, so none of
+     * them can start under another, or turn driver control back on under it.
+     * tryClaimRobot() claims it if it is free and returns whether it did, claimRobot()
+     * waits for it, releaseRobot() frees it, and isRobotClaimed() returns whether anything
+     * holds it. Any task may call these
+     */
+    bool tryClaimRobot();
+    void claimRobot();
+    void releaseRobot();
+    bool isRobotClaimed();
+    /**
+     * Returns the latest SensorFrame. Any task may call this
+     */
+    SensorFrame getSensorFrame();
+    /**
+     * Returns the control task's timing. Any task may call this
+     */
+    ControlStats getControlStats();
+    /**
+     * Raises the task that calls it to the control priority, for autonomous, which
+     * PROS starts in its own task at the default priority
+     */
+    void raiseToControl();
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+/**
+ * The header file for the TextBuffer class, a fixed size character buffer that text and
+ * numbers are written into one after another, used to build label text for the GUI.
+ *
+ * It replaces snprintf for this job: numbers are written with a fixed number of decimal
+ * places using integer math, without printf's slow floating point formatting, and nothing
+ * is ever allocated. If the text doesn't fit, the buffer ends with "..." and overflowed()
+ * returns true, instead of the end of the text being silently cut off.
+ *
+ * Like PidController, the class is a template so the size of the buffer is set where it
+ * is used, and it is defined entirely in this header.
+ */
+template <size_t N>
+class TextBuffer
+{
+    static_assert(N >= 4, "A TextBuffer needs room for \"...\" and the terminating character");
+    private:
+        //The text, always ended with a '\0', and its length
+        char text[N];
+        size_t length;
+        //Whether any text didn't fit
+        bool full;
+
+        /**
+         * Appends one character. If it doesn't fit, the end of the buffer is
+         * replaced with "..." and nothing else is added until clear() is called
+         */
+        bool put(char c)
+        {
+            if(full) return false;
+            if(length + 1 >= N) {
+                full = true;
+                text[N - 4] = '.';
+                text[N - 3] = '.';
+                text[N - 2] = '.';
+                text[N - 1] = '\0';
+                length = N - 1;
+                return false;
+            }
+            text[length++] = c;
+            text[length] = '\0';
+            return true;
+        }
+    public:
+        TextBuffer() { clear(); }
+        /**
+         * Empties the buffer
+         */
+        void clear()
+        {
+            length = 0;
+            full = false;
+            text[0] = '\0';
+        }
+        /**
+         * Appends a string
+         * @return false if the string didn't fit
+         */
+        bool append(const char * str)
+        {
+            //Strings that fit are copied in one go, and ones that don't are added one character at a time up to the limit
+            size_t len = strlen(str);
+            if(!full && length + len < N) {
+                memcpy(text + length, str, len + 1);
+                length += len;
+                return true;
+            }
+            while(*str != '\0') {
+                if(!put(*str++)) return false;
+            }
+            return true;
+        }
+        /**
+         * Appends a whole number. Like appendFixed, numbers with more than 10 digits are written as "err"
+         * @return false if the number didn't fit
+         */
+        bool appendInt(long value)
+        {
+            return appendFixed(value, 0);
+        }
+        /**
+         * Appends a number with a fixed number of decimal places, rounded to the nearest
+         * value. Values too large to write this way, and infinity (which PROS returns as
+         * PROS_ERR_F when a motor can't be read), are written as "err"
+         * @param value The number to append
+         * @param decimals The number of decimal places, from 0 to 6
+         * @return false if the number didn't fit
+         */
+        bool appendFixed(double value, int decimals = 2)
+        {
+            static const long scales[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+            if(decimals < 0) decimals = 0;
+            if(decimals > 6) decimals = 6;
+            //The scaled value has to fit in an unsigned long, which is 32 bits on the V5
+            double scaledValue = fabs(value) * scales[decimals] + 0.5;
+            if(!(scaledValue < 4294967295.0)) return append("err");
+            unsigned long scaled = scaledValue;
+            bool negative = value < 0 && scaled != 0;
+            /**
+             * The value is now a whole number of the smallest decimal place. Its digits
+             * are found from last to first, so they are written from the end of a small
+             * buffer backwards, with the decimal point put in after the decimal places.
+             * NaN fails the comparison above, so it is written as "err" too
+             */
+            char digits[16];
+            char * p = digits + sizeof(digits) - 1;
+            *p = '\0';
+            int written = 0;
+            do {
+                *--p = '0' + scaled % 10;
+                scaled /= 10;
+                if(++written == decimals) *--p = '.';
+            } while(scaled > 0 || written <= decimals);
+            if(negative) *--p = '-';
+            return append(p);
+        }
+        /**
+         * Returns the text, ended with a '\0'
+         */
+        const char * c_str() const { return text; }
+        size_t size() const { return length; }
+        /**
+         * Returns whether any text didn't fit since the buffer was last cleared
+         */
+        bool overflowed() const { return full; }
+};
@@ -0,0 +1,125 @@
+#pragma once
+#include "api.h"
+#include "library.hpp"
+#include <stdio.h>
+/**
+ * The header file for the Timeline namespace, which records when every command in an
+ * autonomous routine starts and ends, and provides the clock commands run on.
+ *
+ * Normally the clock is just pros::millis(). While simulating, the clock only moves
+ * forward when the scheduler finishes a tick, and commands that would move a motor
+ * estimate how long they would take instead. This lets a whole routine be run in a
+ * fraction of a second, without the robot moving, to find out how long it takes and
+ * which steps the time goes to. See AutonAnalyzer.hpp.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+namespace Timeline
+{
+    /**
+     * The kinds of command recorded. Groups only organise other commands, waits
+     * do nothing but pass time, and actions run a part of the robot
+     */
+    enum class Kind
+    {
+        action,
+        wait,
+        group
+    };
+    /**
+     * One command in the timeline: its name and kind, how deep it is nested in
+     * groups, when it started and ended, in milliseconds from the start of the routine,
+     * and whether it is still running
+     */
+    struct Entry
+    {
+        const char * name;
+        Kind kind;
+        uint8_t depth;
+        uint32_t start;
+        uint32_t end;
+        bool running;
+    };
+    /**
+     * The most commands recorded for one routine. Commands after this aren't recorded
+     */
+    constexpr int maxEntries = 256;
+    /**
+     * Clears the timeline and makes now() the start of the routine
+     */
+    void clear();
+    /**
+     * Records a command starting
+     * @return The index of the entry, to be passed to finish(), or -1 if the timeline is full
+     */
+    int begin(const char * name, Kind kind);
+    /**
+     * Records the command with the given entry index ending
+     */
+    void finish(int index);
+    /**
+     * Functions to read the recorded entries
+     */
+    int size();
+    const Entry & get(int index);
+    /**
+     * Returns the name of the action that started most recently and is still running,
+     * or NULL if no action is running. Used to show a routine's progress
+     */
+    const char * currentAction();
+    /**
+     * Returns the time since clear() was called, in milliseconds
+     */
+    uint32_t elapsed();
+    /**
+     * Returns whether a wait entry overlaps no action, meaning the robot sat still
+     * for the whole wait and the wait could be shortened or run alongside a move
+     */
+    bool isIdleWait(int index);
+    /**
+     * Writes the timeline as a JSON object
+     * @param f The file to write to (stdout prints it to the terminal)
+     * @param routine The name of the routine
+     */
+    void writeJson(FILE * f, const char * routine);
+    /**
+     * Turns simulation on or off. Turning it on resets the simulated clock to 0
+     */
+    void setSimulating(bool sim);
+    bool isSimulating();
+    /**
+     * Returns the current time in milliseconds, simulated or real
+     */
+    uint32_t now();
+    /**
+     * Moves the simulated clock forward. Does nothing when not simulating
+     * @param ms The time to move forward, in milliseconds
+     */
+    void advance(uint32_t ms);
+    /**
+     * The drivetrain model used while simulating: the top speed in inches per second and
+     * the acceleration in inches per second squared of a straight move
+     */
+    constexpr double simMaxSpeed = 40;
+    constexpr double simAccel = 80;
+    /**
+     * The simulated time for the indexer to score one ball, in milliseconds
+     */
+    constexpr uint32_t simScoreTime = 350;
+    /**
+     * Estimates how long a move of one side of the drivetrain takes with a trapezoidal
+     * speed profile using simMaxSpeed and simAccel
+     * @param inches The distance the side moves
+     * @return The estimated time in milliseconds
+     */
+    uint32_t simMoveTime(double inches);
+    /**
+     * Where the simulated robot is, in the odometry's frame, so moves to a pose can work
+     * out how far they have to go. Turning simulation on puts it back to {0, 0, 0}, and
+     * each drive command moves it to where it would finish
+     */
+    Pose getSimPose();
+    void setSimPose(Pose pose);
+}
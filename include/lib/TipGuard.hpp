@@ -0,0 +1,111 @@
+#pragma once
+#include "api.h"
+#include "library.hpp"
+#include "Tasks.hpp"
+#include "DoubleBuffer.hpp"
+/**
+ * The header file for the TipGuard class, which shapes the drive's outputs in driver
+ * control so hard reversals don't wheelie or tip the robot over with the conveyor raised.
+ *
+ * It sits between the drive's plan and the motors (see Pipeline.hpp), and does two things:
+ * - limits how fast each side's power may change, with separate limits for speeding up
+ *   forwards, speeding up backwards, and slowing down. A change within the limit is passed
+ *   straight through, so normal driving reaches the motors the same tick it always did,
+ *   and only a jump bigger than the limit (like full forwards to full backwards) is spread
+ *   over a few ticks
+ * - watches the robot's pitch and roll (see Inertial.hpp). Past warnAngle the limits are
+ *   tightened, down to tightScale of themselves at tipAngle. Past tipAngle the driver's
+ *   command is replaced by a push the way the robot is tipping, which drives the wheels
+ *   back under it
+ *
+ * Every tick the output is held back from the driver's command adds latency, so the
+ * guard counts those ticks and how long each run of them lasted (see getStats()). The
+ * cost of the shaping itself is measured by the tip_guard benchmark.
+ *
+ * Without the IMU, the tilt is taken as level, so only the rate limits are used.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class TipGuard
+{
+    public:
+        /**
+         * The latency the guard has added since the program started
+         */
+        struct Stats
+        {
+            //The number of ticks shaped, and of those that sent something other than the driver's command
+            uint32_t ticks;
+            uint32_t heldTicks;
+            /**
+             * The number of runs of held ticks, and the longest one, in milliseconds.
+             * heldTicks * the control period / holds is the average latency each one added
+             */
+            uint32_t holds;
+            uint32_t maxHoldMs;
+            //The number of ticks the robot was past tipAngle, and the times it went past it
+            uint32_t tipTicks;
+            uint32_t tips;
+        };
+        //The fraction the limits are tightened to at tipAngle
+        static constexpr double tightScale = 0.25;
+        /**
+         * The push sent while the robot is past tipAngle: minRecovery, plus recoveryGain for
+         * every degree past it, up to maxRecovery (all in motor_move units, -127 to 127)
+         */
+        static constexpr double minRecovery = 30;
+        static constexpr double recoveryGain = 6;
+        static constexpr double maxRecovery = 90;
+        /**
+         * A gap longer than this (milliseconds) between two ticks means driver control
+         * stopped and started again, so the output starts again from 0 instead of from
+         * wherever it was left
+         */
+        static constexpr uint32_t restartGap = 100;
+
+        /**
+         * The constructor for the TipGuard class
+         * @param forwardAccel How fast a side's power may rise going forwards, in motor_move
+         *                     units (-127 to 127) per second
+         * @param reverseAccel The same, going backwards. A raised conveyor usually makes the
+         *                     robot tip one way more easily than the other
+         * @param brake How fast a side's power may fall towards 0, either way, per second
+         * @param warnAngle The pitch or roll, in degrees, at which the limits start being tightened
+         * @param tipAngle The pitch, in degrees, past which the guard pushes the robot back down
+         */
+        TipGuard(double forwardAccel, double reverseAccel, double brake, double warnAngle, double tipAngle);
+        /**
+         * Shapes the drive's outputs for one tick. Only the task running driver control may
+         * call this
+         * @param frame The inputs of the tick, for the IMU's pitch and roll and the time
+         * @param out The outputs from the drive's plan, which are changed in place
+         */
+        void shape(const Tasks::SensorFrame & frame, MotorOutputs & out);
+        /**
+         * Returns the latency the guard has added. Any task may call this
+         */
+        Stats getStats();
+    private:
+        double forwardAccel, reverseAccel, brake;
+        double warnAngle, tipAngle;
+        //The outputs sent last tick, and the time of that tick's frame in microseconds
+        double lastLeft, lastRight;
+        uint64_t lastTime;
+        //Whether the last tick was held back or past tipAngle, to count each run once
+        bool holding, tipping;
+        //The held ticks in the current run
+        uint32_t holdTicks;
+        DoubleBuffer<Stats> published;
+        Stats stats;
+
+        /**
+         * Moves one side's output towards what was asked for, by no more than its limits allow
+         * @param last The output sent last tick
+         * @param target The output asked for
+         * @param scale The fraction of the limits to use
+         * @param dt The time since the last tick, in seconds
+         */
+        double limit(double last, double target, double scale, double dt);
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+/**
+ * The header file for the TractionControl class, which notices the drive wheels slipping
+ * on the tiles during a move and backs the power off until they grip again.
+ *
+ * A slipping wheel spins faster than the robot moves, so the encoders keep counting while
+ * the robot falls behind, and a move finishes short of its target. The IMU measures how the
+ * robot itself moves, so every update the wheels are compared with it two ways:
+ * - driving: the IMU's forward acceleration is added up into the robot's speed (pulled back
+ *   towards the wheels' speed whenever they agree, so it doesn't drift), and the wheels
+ *   slip if they are going much faster or slower than that, or changing speed much faster
+ *   than the IMU says the robot is
+ * - turning: the wheels slip if they say the robot is turning much faster than the gyro does
+ * If either lasts for detectTicks updates in a row, that is a slip event. The output is
+ * then cut by backoff every update until the slip stops, and brought back up by recovery
+ * each update after, so the wheels are kept near the most force the tiles can take
+ * rather than spinning (a spinning wheel grips less than one that is only just holding).
+ *
+ * Without the IMU, nothing is ever detected and the output is never cut.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class TractionControl
+{
+    public:
+        /**
+         * The wheels are slipping while driving if their speed is more than slipSpeed
+         * inches per second, or slipFraction of their speed, away from the robot's, or their
+         * acceleration is more than slipAccel inches per second squared away from its
+         */
+        static constexpr double slipSpeed = 4;
+        static constexpr double slipFraction = 0.25;
+        static constexpr double slipAccel = 100;
+        /**
+         * The wheels are slipping while turning if they say the robot is turning more than
+         * slipTurnRate degrees per second, or slipFraction of their rate, faster than the gyro
+         */
+        static constexpr double slipTurnRate = 15;
+        //The updates in a row a slip has to last to count, so one noisy reading doesn't
+        static constexpr int detectTicks = 2;
+        /**
+         * The output is multiplied by backoff each update the wheels slip, down to
+         * minScale, and raised by recovery each update after
+         */
+        static constexpr double backoff = 0.75;
+        static constexpr double minScale = 0.4;
+        static constexpr double recovery = 0.05;
+        //How quickly the robot's speed is pulled towards the wheels' while they agree, each update
+        static constexpr double anchor = 0.2;
+
+        TractionControl();
+        /**
+         * Starts watching a new move
+         * @param wheelVelocity The speed the wheels are going now, in inches per second
+         */
+        void reset(double wheelVelocity);
+        /**
+         * Checks the wheels against the IMU once. Only the task running the move may call this
+         * @param wheelVelocity The average speed of the two sides, in inches per second
+         * @param wheelTurnRate The turn rate the two sides give, in degrees per second, clockwise
+         * @param accel The IMU's forward acceleration in inches per second squared, or
+         *              PROS_ERR_F if it isn't ready
+         * @param gyroRate The IMU's turn rate in degrees per second, clockwise, or PROS_ERR_F
+         * @param dt The time since the last update, in seconds
+         * @return The fraction of the output to send to the motors, from minScale to 1
+         */
+        double update(double wheelVelocity, double wheelTurnRate, double accel, double gyroRate, double dt);
+        /**
+         * Returns whether the wheels are slipping, as of the last update
+         */
+        bool isSlipping();
+        /**
+         * Returns the number of slip events since the program started. Any task may call this
+         */
+        uint32_t getSlipEvents();
+    private:
+        //The robot's speed, from the IMU, and the wheels' speed at the last update, in inches per second
+        double chassisVelocity, lastWheelVelocity;
+        //The updates in a row the wheels have looked like they were slipping
+        int slipTicks;
+        bool slipping;
+        //The fraction of the output being sent
+        double scale;
+        std::atomic<uint32_t> slipEvents;
+};
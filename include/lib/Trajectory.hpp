@@ -0,0 +1,126 @@
+#pragma once
+#include "api.h"
+#include "TankDrive.hpp"
+/**
+ * The header file for the Trajectory class, which plans the fastest speed the robot can
+ * drive a path at, and turns the path into a table of where the robot should be, and how
+ * fast each side should be going, at each moment.
+ *
+ * The robot's speed along the path is limited by:
+ * - its top speed, and how fast it can speed up and slow down
+ * - how hard it can corner: in a curve the tiles have to push the robot sideways, and past
+ *   maxLateralAccel the wheels slide. Grip used for cornering can't also be used for
+ *   speeding up, so the acceleration is shared between the two (a friction ellipse)
+ * - how fast each wheel can turn: in a curve the outside wheels go faster than the middle
+ *   of the robot, so the middle has to slow down for them to stay under the gearset's
+ *   top speed (see TankDrive's constructor)
+ * The planner finds the highest speed at every point allowed by the curvature, then runs
+ * forwards along the path limiting how fast the speed can rise, and backwards limiting how
+ * fast it can fall, which gives the fastest speeds that meet every limit at once.
+ * Keeping the wheels from slipping keeps the encoder odometry accurate too.
+ *
+ * Paths are given as points, and a Catmull-Rom spline is fitted through them, which goes
+ * through every point and rounds the corners between them. The spline is filled in about
+ * every spacing inches, and the heading and curvature come from the spline itself, so they
+ * are the same whatever the spacing. Tightly packed points with a sharp turn still make a
+ * tight curve, which the robot has to slow right down for.
+ *
+ * Everything is stored in fixed size arrays in the object, so planning never allocates
+ * on the heap. Positions and headings use the same units and frame as the Pose.
+ *
+ * The comments in this header file explain the purpose of each member object or function,
+ * while the comments in the respective source file explain the inner workings of each
+ * function
+ */
+class Trajectory
+{
+    public:
+        struct Point
+        {
+            double x;
+            double y;
+        };
+        /**
+         * The limits the plan has to keep to: the top speed (inches per second), the
+         * largest acceleration and cornering acceleration (inches per second squared),
+         * each wheel's top speed (inches per second) and the width of the base (inches)
+         */
+        struct Limits
+        {
+            double maxVelocity;
+            double maxAccel;
+            double maxLateralAccel;
+            double wheelMaxVelocity;
+            double trackWidth;
+        };
+        /**
+         * One row of the table: the time from the start (seconds), the distance along the
+         * path (inches), the position and heading, the speed (inches per second) and
+         * acceleration (inches per second squared) of the middle of the robot, the
+         * curvature (1 / the radius of the turn in inches, positive clockwise), and the
+         * speed of each side (inches per second)
+         */
+        struct State
+        {
+            double time;
+            double distance;
+            double x;
+            double y;
+            double heading;
+            double velocity;
+            double accel;
+            double curvature;
+            double leftVelocity;
+            double rightVelocity;
+        };
+        //The most rows a plan can have
+        static constexpr int maxPoints = 200;
+
+        /**
+         * The constructor for the Trajectory class. The table starts empty
+         */
+        Trajectory();
+
+        /**
+         * Returns the limits for a drivetrain: the wheels' top speed comes from its gearset
+         * and wheel diameter, and the top speed of the robot is the same
+         * @param drive The drivetrain
+         * @param maxAccel The largest acceleration, in inches per second squared
+         * @param maxLateralAccel The largest cornering acceleration, in inches per second squared
+         * @param speedFraction The fraction of the wheels' top speed to plan for, which leaves
+         *                      some headroom for the controller following the plan
+         */
+        static Limits limitsFor(TankDrive & drive, double maxAccel, double maxLateralAccel,
+                                double speedFraction = 0.9);
+        /**
+         * Plans the path through the given points
+         * @param points The points the path goes through, in order
+         * @param count The number of points
+         * @param spacing The distance between rows of the table, in inches
+         * @param limits The limits to keep to
+         * @param startVelocity The speed at the start of the path, in inches per second
+         * @param endVelocity The speed at the end of the path, in inches per second
+         * @return false if there are fewer than 2 points or the path needs more than
+         *         maxPoints rows, in which case the table is left empty
+         */
+        bool plan(const Point * points, int count, double spacing, const Limits & limits,
+                  double startVelocity = 0, double endVelocity = 0);
+        /**
+         * Return the number of rows in the table, and one row
+         */
+        int size();
+        const State & get(int index);
+        /**
+         * Returns the time the whole path takes, in seconds
+         */
+        double getDuration();
+        /**
+         * Returns the state at a time, interpolated between the rows either side of it.
+         * Times past either end give the first or last row
+         * @param time The time from the start of the path, in seconds
+         */
+        State sample(double time);
+    private:
+        State states[maxPoints];
+        int stateCount;
+};
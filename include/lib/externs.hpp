@@ -2,6 +2,25 @@
 #include "lib/TankDrive.hpp"
 #include "lib/intake.hpp"
 #include "lib/Conveyor.hpp"
+#include "lib/PowerManager.hpp"
+#include "lib/Indexer.hpp"
+#include "lib/ColorSorter.hpp"
+#include "lib/Recorder.hpp"
+#include "lib/RobotCommands.hpp"
+#include "lib/AutonAnalyzer.hpp"
+#include "lib/Benchmark.hpp"
+#include "lib/TaskMonitor.hpp"
+#include "lib/Tasks.hpp"
+#include "lib/Pipeline.hpp"
+#include "lib/Odometry.hpp"
+#include "lib/PoseEKF.hpp"
+#include "lib/Localizer.hpp"
+#include "lib/Trajectory.hpp"
+#include "lib/Inertial.hpp"
+#include "lib/TipGuard.hpp"
+#include "lib/PreArm.hpp"
+#include "lib/Calibration.hpp"
+#include <atomic>
 
 /**
  * This header file contains declarations for objects and
@@ -19,6 +38,53 @@ extern Intake intake;
 
 //The Conveyor object, representing the conveyor that moves balls up and scores them
 extern Conveyor conveyor;
+//The PowerManager object, which splits the current budget between all the motors above
+extern PowerManager power;
+//The Indexer object, which runs the intake and conveyor from the line trackers on the conveyor
+extern Indexer indexer;
+//The ColorSorter object, which throws out balls of the opponent's color
+extern ColorSorter sorter;
+//The Recorder object, which records driver control and replays it as an autonomous routine
+extern Recorder recorder;
+//The CommandScheduler object, which runs the commands autonomous routines are built from
+extern CommandScheduler scheduler;
+//The Odometry object, which tracks the robot's pose from the drive encoders
+extern Odometry odom;
+//The PoseEKF object, which estimates the robot's pose from the drive encoders and the IMU together
+extern PoseEKF ekf;
+//The Localizer object, which corrects the odometry from Distance sensors pointed at the field walls
+extern Localizer localizer;
+//The Inertial object, representing the robot's IMU
+extern Inertial imu;
+//The TipGuard object, which limits the drive's acceleration in driver control and keeps the robot from tipping
+extern TipGuard tipGuard;
+/**
+ * Runs one tick of driver control from a controller state. It is defined in
+ * opcontrol.cpp and used both by the control task (see Tasks.hpp) and by the Recorder when replaying
+ */
+void driverTick(const ControllerState & input);
+/**
+ * Runs the selected autonomous routine in the task that calls it. It is defined in
+ * autonomous.cpp and used both by autonomous() and by the GUI's autonomous task, each
+ * of which registers itself with the TaskMonitor at its very start and passes its id in.
+ * competition is true for autonomous(), whose task PROS may end partway through
+ */
+void runAutonomous(int monitorId, bool competition);
+/**
+ * Frees whatever a competition task that PROS ended partway through was holding: an
+ * unfinished arm (see PreArm::recover()), or the locks of an unfinished autonomous().
+ * It is defined in autonomous.cpp and called at the start of autonomous(), opcontrol()
+ * and disabled(), as PROS only starts each of those once the last one has ended
+ */
+void recoverAutonomous();
+/**
+ * Builds the command graph for an autonomous routine. It is defined in
+ * autonomous.cpp and used both by autonomous() and by AutonAnalyzer
+ */
+Command * buildRoutine(Auton id);
 
-//The Auton enumerator used to store the currently selected autonomous routine
-extern Auton autonID;
\ No newline at end of file
+/**
+ * The Auton enumerator used to store the currently selected autonomous routine.
+ * It is set by the GUI and read by the autonomous task, so it is atomic
+ */
+extern std::atomic<Auton> autonID;
\ No newline at end of file
@@ -91,12 +91,27 @@ namespace GUI
 
     //The function to update label displaying the selected autonomous routine
     void updateAutonLbl();
+    /**
+     * The callback function for the color sorting button matrix, sets the
+     * color of ball the ColorSorter throws out
+     */ 
+    lv_res_t updateRejectColor(lv_obj_t * btnm, const char * txt);
 
     /**
      * The callback function for the debugData button matrix, displays the
      * selected telemetry data using updateTelemetryLabel
      */ 
     lv_res_t updateTelemetryData(lv_obj_t * btnm, const char* txt);
+    /**
+     * Shows the CPU and stack use of each task, and the heap use, from the
+     * TaskMonitor's last sample on the debug screen labels
+     */ 
+    void updateTaskLabels();
+    /**
+     * Prints the Profiler's summary to the terminal, and shows the mean and
+     * maximum time of each probe on the debug screen labels
+     */ 
+    void updateProfileLabels();
 
     /**
      * A function used to update any telemetry label.
@@ -112,11 +127,41 @@ namespace GUI
     void updateTelemetry();
 
     /**
-     * A function used to call autonomous() when the runAuton button is pressed
-     * LVGL requires callback functions to return type lv_res_t, so I had
-     * to wrap autonomous() in this function
+     * The callback function for the runAuton button. It starts autonomous() in a task of
+     * its own, so the screen doesn't freeze while the routine runs, or cancels the
+     * routine if it is already running
      */ 
     lv_res_t runAuton(lv_obj_t * btn);
+    /**
+     * An LVGL task that shows the progress of an autonomous started with runAuton
+     * on the autonomous screen, and switches the button between Run and Stop
+     */ 
+    void updateAutonProgress(void * param);
+    /**
+     * The callback function for the record button, which starts or stops
+     * recording driver control for the Replay autonomous
+     */ 
+    lv_res_t toggleRecording(lv_obj_t * btn);
+    /**
+     * The callback function for the analyze button, which simulates every
+     * autonomous routine with AutonAnalyzer and shows the longest one's time
+     */ 
+    lv_res_t analyzeAutons(lv_obj_t * btn);
+    /**
+     * The callback function for the benchmark button, which runs the benchmarks
+     * and shows how many got slower than the baseline
+     */ 
+    lv_res_t runBenchmarks(lv_obj_t * btn);
+    /**
+     * The callback function for a long press of the benchmark button, which drives
+     * the robot to compare the TankDrive move modes (see Benchmark.hpp)
+     */ 
+    lv_res_t compareMoveModes(lv_obj_t * btn);
+    /**
+     * The callback function for the calibrate button, which steps through measuring the
+     * drive's wheel diameter and track width (see Calibration.hpp)
+     */ 
+    lv_res_t calibrateDrive(lv_obj_t * btn);
 
     //Functions to navigate to specific LVGL Screens. Used in the navigation buttons
     lv_res_t goToMain(lv_obj_t * btn);
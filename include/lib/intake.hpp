@@ -1,6 +1,7 @@
 #pragma once
 #include "api.h"
 #include "library.hpp"
+#include "JamDetector.hpp"
 #include <vector>
 #include <initializer_list>
 /**
@@ -31,6 +32,11 @@ class Intake
     * take in or push out an object
     */ 
         pros::controller_digital_e_t inButton, outButton;
+    /**
+     * Every power sent to the motors goes through the JamDetector, which
+     * clears a jammed ball by running the intake backwards for a moment
+     */
+        JamDetector jam;
     /**
      * Functions to update the telemetry data for each motor
      */ 
@@ -53,6 +59,22 @@ class Intake
      * @param controller The ID of the controller to get input from
      */ 
         void driver(pros::controller_id_e_t controller);
+    /**
+     * The same as driver(), but using a ControllerState (defined in library.hpp)
+     * that has already been read, either from the controller or from a recording
+     * @param input The controller state to get button presses from
+     */ 
+        void driver(const ControllerState & input);
+    /**
+     * Works out what driver() would send to the motors, without sending it
+     * @param input The controller state to get button presses from
+     * @param out The outputs to fill in the intake's part of (see library.hpp)
+     */ 
+        void plan(const ControllerState & input, MotorOutputs & out) const;
+    /**
+     * Sets the power of the motors, from -127 (push out) to 127 (take in)
+     */ 
+        void setPower(int power);
     /**
      * A function to set the motors to take out an object
      */ 
@@ -71,4 +93,13 @@ class Intake
      */ 
         Telemetry getLeftTelemetry();
         Telemetry getRightTelemetry();
+    /**
+     * A function to retrieve the ports of the intake motors
+     * @return A vector of the ports of the intake motors
+     */ 
+        std::vector<int> getMotorPorts();
+    /**
+     * A function to retrieve the intake's JamDetector, to change its thresholds or read its jam count
+     */
+        JamDetector & getJamDetector();
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include "api.h"
 /**
  * library.hpp includes a few type definitions 
  * that I use throughout my code.
@@ -20,9 +21,67 @@ enum class Auton
     midleft,
     midright,
     left,
-    right
+    right,
+    replay
 }; 
 
+/**
+ * The MoveMode enumerator selects how a TankDrive move closes its position loop:
+ * brain: the brain runs a PID controller on the encoders every 20 ms and sends
+ *        voltages to the motors (TankDrive's original moves)
+ * onboard: each motor is given its target and runs its own position controller,
+ *        which updates much faster than the brain can over the smart port. The
+ *        brain only sets the speed limit of each side and checks when the move is done
+ */
+enum class MoveMode
+{
+    brain,
+    onboard
+};
+
+/**
+ * The PowerPriority enumerator is used by the PowerManager to
+ * decide which motor groups get their share of the current budget
+ * first. Groups with a high priority (the drivetrain) are served
+ * before groups with a low priority (intakes, conveyor) whenever
+ * they are moving.
+ */
+enum class PowerPriority
+{
+    high,
+    low
+};
+
+/**
+ * The IndexerState enumerator holds the states of the Indexer's
+ * state machine:
+ * idle: the indexer leaves the intake and conveyor motors alone
+ * intaking: balls are pulled in and moved up until the conveyor is full
+ * holding: the intake and conveyor are stopped, keeping the balls in place
+ * shooting: balls are pushed out the top until the requested number have left
+ * ejecting: the conveyor and intake run backwards to throw a ball out the bottom
+ */
+enum class IndexerState
+{
+    idle,
+    intaking,
+    holding,
+    shooting,
+    ejecting
+};
+
+/**
+ * The BallColor enumerator holds the colors the ColorSorter can
+ * tell apart. It is also used to store which color of ball the
+ * ColorSorter should throw out, where none turns sorting off.
+ */
+enum class BallColor
+{
+    none,
+    red,
+    blue
+};
+
 /**
  * The telemetry structure is a way to package the values of 
  * a few of the telemetry readings from a motor into a single
@@ -39,3 +98,95 @@ struct Telemetry
     double torque;
 };
 
+
+/**
+ * The ControllerState structure holds everything read from a controller
+ * in one driver control tick: the four joystick axes and a bitmask of the
+ * twelve buttons. Reading the controller once into a ControllerState and
+ * passing it to every subsystem means the subsystems can be driven just as
+ * well from a recording as from the real controller
+ */
+struct ControllerState
+{
+    int8_t analog[4];
+    uint16_t digital;
+    /**
+     * Returns the value of a joystick axis, from -127 to 127
+     */
+    int getAnalog(pros::controller_analog_e_t axis) const
+    {
+        return analog[axis];
+    }
+    /**
+     * Returns whether a button is pressed. The buttons start at
+     * E_CONTROLLER_DIGITAL_L1, so that button is bit 0 of the mask
+     */
+    bool getDigital(pros::controller_digital_e_t button) const
+    {
+        return (digital >> (button - pros::E_CONTROLLER_DIGITAL_L1)) & 1;
+    }
+    /**
+     * Reads the current state of a controller
+     * @param controller The ID of the controller to read
+     */
+    static ControllerState read(pros::controller_id_e_t controller)
+    {
+        ControllerState s;
+        for(int i = 0; i < 4; i++) {
+            s.analog[i] = pros::c::controller_get_analog(controller, (pros::controller_analog_e_t)i);
+        }
+        s.digital = 0;
+        for(int b = pros::E_CONTROLLER_DIGITAL_L1; b <= pros::E_CONTROLLER_DIGITAL_A; b++) {
+            if(pros::c::controller_get_digital(controller, (pros::controller_digital_e_t)b) == 1) {
+                s.digital |= 1 << (b - pros::E_CONTROLLER_DIGITAL_L1);
+            }
+        }
+        return s;
+    }
+};
+
+
+/**
+ * The Pose structure holds where the robot is on the field: its position
+ * in inches from where it started, and its heading in degrees. The heading
+ * works like a compass (and the IMU): 0 is the way the robot faced when it
+ * started, and it increases clockwise. x is to the right of the starting
+ * direction, and y is straight ahead of it
+ */
+struct Pose
+{
+    double x;
+    double y;
+    double theta;
+};
+
+/**
+ * Keeps an angle in degrees between -180 and 180, so the difference between
+ * two headings is the shortest way round from one to the other
+ */
+inline double wrap180(double angle)
+{
+    angle = fmod(angle + 180, 360);
+    if(angle < 0) angle += 360;
+    return angle - 180;
+}
+
+
+/**
+ * The MotorOutputs structure holds everything one tick of driver control
+ * decided to send to the motors, from -127 to 127 like motor_move. Each
+ * subsystem fills in its own part in its plan() function, and the whole
+ * thing is written to the motors at once by Pipeline::flush(). A mechanism
+ * whose flag is false is left alone, so whatever else is running it (like
+ * the Indexer while it ejects a ball) keeps control of it
+ */
+struct MotorOutputs
+{
+    int8_t driveLeft;
+    int8_t driveRight;
+    int8_t intake;
+    int8_t conveyor;
+    bool driveSet;
+    bool intakeSet;
+    bool conveyorSet;
+};
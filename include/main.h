@@ -43,6 +43,8 @@
 #include "lib/library.hpp"
 #include "lib/externs.hpp"
 #include "lib/gui.hpp"
+#include "lib/TextBuffer.hpp"
+#include "lib/Profiler.hpp"
 /**
  * If you find doing pros::Motor() to be tedious and you'd prefer just to do
  * Motor, you can use the namespace with the following commented out line.
@@ -1,89 +1,205 @@
 #include "main.h"
+#include <atomic>
 
 /**
- * Runs the user autonomous code. This function will be started in its own task
- * with the default priority and stack size whenever the robot is enabled via
- * the Field Management System or the VEX Competition Switch in the autonomous
- * mode. Alternatively, this function may be called in initialize or opcontrol
- * for non-competition testing purposes.
- *
- * If the robot is disabled or communications is lost, the autonomous task
- * will be stopped. Re-enabling the robot will restart the task, not re-start it
- * from where it left off.
+ * The effective wheel diameter and base width the routines below were tuned with,
+ * in inches: the ones passed into the TankDrive constructor. When the routines are
+ * retuned on a calibrated robot, these become the calibrated values
  */
-void autonomous() {
-    drive.moveStraight(6);
-    conveyor.moveUp();
-    pros::delay(500);
-    conveyor.stop();
-    pros::delay(50);
-    switch(autonID)
+static constexpr double tunedWheelDiameter = 2;
+static constexpr double tunedBaseWidth = 12.75;
+
+/**
+ * Builds the command graph for an autonomous routine in the CommandPool. It is
+ * used both by autonomous() and by AutonAnalyzer, which simulates every routine
+ */
+Command * buildRoutine(Auton id) {
+    /**
+     * Each routine is built as a graph of commands (see Command.hpp and
+     * RobotCommands.hpp) and then run by the scheduler. Anything that used to
+     * be started before a move and stopped after it, like running the intake
+     * while backing up, is put in a deadline with that move so it runs for
+     * exactly as long as the move does. Anything that used to wait for a move
+     * to finish, like spitting out a ball once the robot has backed away, stays
+     * after it in the sequence
+     */
+    using namespace Commands;
+    /**
+     * The routines were tuned on the field with the geometry the drive was
+     * built with, so their distances and angles are really how far the motors
+     * turn in that geometry. Once Calibration has loaded the measured geometry,
+     * an inch and a degree here are scaled so the motors still turn as far as
+     * they did when the routines were tuned. Motor degrees for a straight move
+     * go as 1 / wheelDiameter, and for a turn as baseWidth / wheelDiameter
+     */
+    double inch = drive.getWheelDiameter() / tunedWheelDiameter;
+    double degree = inch * tunedBaseWidth / drive.getBaseWidth();
+    Command * routine = NULL;
+    switch(id)
     {
         case Auton::test:
-            drive.moveStraight(17);
-            drive.turnAngle(-140);
-            drive.moveStraight(28);
-            intake.in();
-            drive.moveStraight(6);
-            pros::delay(5000);
-            drive.moveStraight(-12);
-            pros::delay(1000);
-            intake.stop();
-            break;
-        case Auton::skills:
+            routine = sequence({
+                straight(drive, 17 * inch),
+                turn(drive, -140 * degree),
+                straight(drive, 28 * inch),
+                deadline({
+                    sequence({straight(drive, 6 * inch), wait(5000), straight(drive, -12 * inch), wait(1000)}),
+                    runIntake(intake, 1)
+                })
+            });
             break;
         case Auton::left:
-            drive.moveStraight(12);
-            drive.turnAngle(-128);
-            intake.in();
-            conveyor.moveUp();
-            drive.moveStraight(23);
-            pros::delay(1500);
-            drive.moveStraight(6);
-            pros::delay(1000);
-            intake.stop();
-            pros::delay(1000);
-            conveyor.stop();
-            drive.moveStraight(-8);
-            intake.out();
-            pros::delay(2000);
-            intake.stop();
+            routine = sequence({
+                straight(drive, 12 * inch),
+                turn(drive, -128 * degree),
+                indexerIntake(indexer),
+                straight(drive, 23 * inch),
+                score(indexer, 1),
+                //A score ends holding, which stops the intake, so it is started again for the move up to the second ball
+                deadline({straight(drive, 6 * inch), indexerIntake(indexer)}),
+                score(indexer, 1),
+                straight(drive, -8 * inch),
+                race({runIntake(intake, -1), wait(2000)})
+            });
             break;
         case Auton::midleft:
-            drive.moveStraight(12);
-            drive.turnAngle(90);
-            drive.moveStraight(16.75);            
-            drive.turnAngle(95);
-            drive.moveStraight(15.25);
-            conveyor.moveUp();
-            pros::delay(3000);
-            conveyor.stop();
-            intake.out();
-            drive.moveStraight(-8);
-            intake.stop();
-            drive.turnAngle(90);
-            intake.in();
-            drive.moveStraight(40);
-            intake.stop();
+            routine = sequence({
+                straight(drive, 12 * inch),
+                turn(drive, 90 * degree),
+                straight(drive, 16.75 * inch),
+                turn(drive, 95 * degree),
+                straight(drive, 15.25 * inch),
+                /**
+                 * The Indexer runs the intake along with the conveyor while it
+                 * shoots, and stops once the ball has left the top, instead of
+                 * running only the conveyor for 3 seconds. The intake is turned
+                 * round straight afterwards to push out while backing away
+                 */
+                score(indexer, 1),
+                deadline({straight(drive, -8 * inch), runIntake(intake, -1)}),
+                turn(drive, 90 * degree),
+                deadline({straight(drive, 40 * inch), runIntake(intake, 1)})
+            });
             break;
         case Auton::right:
-            drive.moveStraight(15);
-            drive.turnAngle(140);
-            intake.in();
-            conveyor.moveUp();
-            drive.moveStraight(30);
-            pros::delay(1500);
-            drive.moveStraight(6);
-            pros::delay(1000);
-            intake.stop();
-            pros::delay(1000);
-            conveyor.stop();
-            drive.moveStraight(-8);
-            intake.out();
-            pros::delay(2000);
-            intake.stop();
+            routine = sequence({
+                straight(drive, 15 * inch),
+                turn(drive, 140 * degree),
+                indexerIntake(indexer),
+                straight(drive, 30 * inch),
+                score(indexer, 1),
+                //A score ends holding, which stops the intake, so it is started again for the move up to the second ball
+                deadline({straight(drive, 6 * inch), indexerIntake(indexer)}),
+                score(indexer, 1),
+                straight(drive, -8 * inch),
+                race({runIntake(intake, -1), wait(2000)})
+            });
             break;
+        case Auton::skills:
+        case Auton::midright:
         case Auton::none:
+        case Auton::replay:
             break;
     }
-}
\ No newline at end of file
+    /**
+     * Every routine starts by driving forward 6 inches, then running the
+     * conveyor for half a second to score the preload. routine is NULL when
+     * there is nothing else to run, and groups skip NULL commands
+     */
+    return sequence({
+        straight(drive, 6 * inch),
+        race({runConveyor(conveyor, 1), wait(500)}),
+        routine
+    });
+}
+
+/**
+ * Runs the user autonomous code. This function will be started in its own task
+ * with the default priority and stack size whenever the robot is enabled via
+ * the Field Management System or the VEX Competition Switch in the autonomous
+ * mode. Alternatively, this function may be called in initialize or opcontrol
+ * for non-competition testing purposes.
+ *
+ * If the robot is disabled or communications is lost, the autonomous task
+ * will be stopped. Re-enabling the robot will restart the task, not re-start it
+ * from where it left off.
+ */
+void autonomous() {
+    //PROS ends the disabled task before starting this one, so an unfinished arm is cleaned up first
+    recoverAutonomous();
+    //PROS runs autonomous() at the start of its own task, with the default stack size
+    runAutonomous(TaskMonitor::add("autonomous", TASK_STACK_DEPTH_DEFAULT), true);
+}
+
+/**
+ * Whether autonomous() holds the robot (see Tasks.hpp) and the AutonAnalyzer's
+ * lock. Each is only set while it is held, so recoverAutonomous() can't free
+ * one the GUI holds
+ */
+static std::atomic<bool> competitionClaimed(false);
+static std::atomic<bool> competitionLocked(false);
+
+void recoverAutonomous() {
+    PreArm::recover();
+    if(competitionLocked.exchange(false)) AutonAnalyzer::unlock();
+    if(competitionClaimed.exchange(false)) Tasks::releaseRobot();
+}
+
+void runAutonomous(int monitorId, bool competition) {
+    uint64_t startTime = pros::c::micros();
+    /**
+     * The robot is claimed first, so nothing else drives it during the
+     * routine. The GUI doesn't start anything that drives while it is claimed,
+     * so this only waits if the move mode comparison or the drive calibration
+     * was already running when a competition autonomous started
+     */
+    Tasks::claimRobot();
+    if(competition) competitionClaimed = true;
+    /**
+     * The control task stops driving while autonomous runs, and this task is
+     * raised to the control task's priority so the routine keeps the same
+     * timing driver control has. Driver control is handed back afterwards if
+     * it was running, which it is when the GUI starts a routine
+     */
+    bool wasDriverControl = Tasks::isDriverControl();
+    Tasks::setDriverControl(false);
+    Tasks::raiseToControl();
+    Auton id = autonID;
+    /**
+     * The lock is held for the whole routine, so nothing resets the CommandPool
+     * under it. It is only held by the GUI's analysis, which takes well under a
+     * second, or by a simulation before a GUI autonomous
+     */
+    AutonAnalyzer::lock();
+    if(competition) competitionLocked = true;
+    //The routine was usually built while the robot was disabled (see PreArm.hpp)
+    Command * routine = PreArm::take(id);
+    /**
+     * A replayed recording starts from where driver control started, so it
+     * skips the moves every other routine starts with
+     */
+    if(id == Auton::replay) {
+        recorder.replay(driverTick);
+    }
+    else {
+        if(routine == NULL) {
+            CommandPool::reset();
+            routine = buildRoutine(id);
+        }
+        /**
+         * The timeline of the real run is reported the same way AutonAnalyzer
+         * reports a simulated one, so the two can be compared. Nothing is
+         * printed until the routine is over, so the first tick isn't held up
+         */
+        Timeline::clear();
+        scheduler.runToCompletion(routine, monitorId);
+        PreArm::recordFirstMotion(scheduler.getFirstTickTime() - startTime);
+        AutonAnalyzer::report(id);
+    }
+    competitionLocked = false;
+    AutonAnalyzer::unlock();
+    PreArm::print();
+    Tasks::setDriverControl(wasDriverControl);
+    competitionClaimed = false;
+    Tasks::releaseRobot();
+}
@@ -1,8 +1,37 @@
 #include "main.h"
 
-TankDrive drive({13, 10} , {3, 11} , {false, false}, {true, true}, pros::E_MOTOR_GEARSET_18, 4, 12.75, 27, 0, 0);
+/**
+ * The moves used to double every distance after converting it with a 4 inch wheel, so the
+ * effective diameter starts at 2 inches (most likely a 2:1 ratio between the motors and the
+ * wheels). Calibration replaces it and the base width with measured values from the microSD card
+ */
+TankDrive drive({13, 10} , {3, 11} , {false, false}, {true, true}, pros::E_MOTOR_GEARSET_18, 2, 12.75, 27, 0, 0);
 Intake intake({18, 12}, {false, true}, pros::E_MOTOR_GEARSET_18, pros::E_CONTROLLER_DIGITAL_L1, pros::E_CONTROLLER_DIGITAL_L2);
 Conveyor conveyor({15}, {true}, pros::E_MOTOR_GEARSET_18, pros::E_CONTROLLER_DIGITAL_R1, pros::E_CONTROLLER_DIGITAL_R2);
+/**
+ * 15 A split between the seven motors. Running all of them flat out would ask for 17.5 A,
+ * so when the drive is moving the intakes and conveyor give up some of their current
+ */
+PowerManager power(15000);
+Indexer indexer(intake, conveyor, 'A', 'B', 'C', 200);
+ColorSorter sorter(indexer, 8, 100, 4, 40);
+Recorder recorder("/usd/replay.bin", Tasks::control.period);
+CommandScheduler scheduler;
+Odometry odom(drive);
+PoseEKF ekf(drive);
+/**
+ * Distance sensors on the left, right and back of the robot. The robot starts against the
+ * driver station wall, in the middle of the second tile from the left, facing away from it
+ */
+Localizer localizer({{6, -7, 0, 270}, {7, 7, 0, 90}, {9, 0, -7, 180}}, {36, 9, 0});
+Inertial imu(5);
+/**
+ * At full strength a side can go from stopped to full power in 2 ticks, and from full
+ * forwards to full backwards in 5, so only the hardest reversals are held back. The
+ * raised conveyor tips the robot over backwards more easily, so going backwards is
+ * limited more. The limits tighten past 5 degrees of tilt, and past 12 the robot is pushed back down
+ */
+TipGuard tipGuard(3200, 2400, 4000, 5, 12);
 /**
  * Runs initialization code. This occurs as soon as the program is started.
  *
@@ -11,7 +40,33 @@ Conveyor conveyor({15}, {true}, pros::E_MOTOR_GEARSET_18, pros::E_CONTROLLER_DIG
  */
 void initialize() 
 {
-    GUI::initialize();
+    //GUI::initialize() can only run once, so it is timed here for the benchmarks
+    Benchmark::measureOnce("gui_initialize", GUI::initialize);
+    //Loading the measured drive geometry before any task uses it
+    Calibration::load();
+    /**
+     * The IMU starts calibrating straight away, without waiting for it, as
+     * disabled() (where PreArm would start it) never runs without a
+     * competition switch or field control. The robot must sit still for the
+     * first couple of seconds after the program starts
+     */
+    imu.calibrate();
+    //Registering every motor with the power manager, drivetrain first
+    power.addGroup(drive.getMotorPorts(), PowerPriority::high);
+    power.addGroup(intake.getMotorPorts(), PowerPriority::low);
+    power.addGroup(conveyor.getMotorPorts(), PowerPriority::low);
+    power.start();
+    indexer.start();
+    sorter.start();
+    /**
+     * The conveyor is only run backwards briefly to clear a jam, so the balls
+     * already indexed above it only drop back a little
+     */
+    JamDetector::Thresholds conveyorJams;
+    conveyorJams.reverseTime = 150;
+    conveyor.getJamDetector().configure(conveyorJams);
+    //The control, sensor, odometry, jam, localizer and logging tasks, laid out in Tasks.hpp
+    Tasks::start();
 }
 
 /**
@@ -19,7 +74,13 @@ void initialize()
  * the VEX Competition Switch, following either autonomous or opcontrol. When
  * the robot is enabled, this task will exit.
  */
-void disabled() {}
+void disabled() {
+    //PROS ends the autonomous task before starting this one, so a routine it cut short is cleaned up first
+    recoverAutonomous();
+    Tasks::setDriverControl(false);
+    //Getting the selected routine ready while the robot sits still, until PROS ends this task
+    PreArm::run();
+}
 
 /**
  * Runs after initialize(), and before autonomous when connected to the Field
@@ -30,4 +91,6 @@ void disabled() {}
  * This task will exit when the robot is enabled and autonomous or opcontrol
  * starts.
  */
-void competition_initialize() {}
\ No newline at end of file
+void competition_initialize() {
+    PreArm::run();
+}
\ No newline at end of file
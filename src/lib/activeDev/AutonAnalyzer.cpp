@@ -0,0 +1,91 @@
+#include "main.h"
+#include <atomic>
+
+/**
+ * The implementation of the AutonAnalyzer namespace
+ * This file contains the source code for the AutonAnalyzer functions, along with
+ * explanations of how each function works
+ */
+
+const char * AutonAnalyzer::getName(Auton id) {
+    switch(id)
+    {
+        case Auton::none: return "none";
+        case Auton::test: return "test";
+        case Auton::skills: return "skills";
+        case Auton::midleft: return "midleft";
+        case Auton::midright: return "midright";
+        case Auton::left: return "left";
+        case Auton::right: return "right";
+        case Auton::replay: return "replay";
+    }
+    return "unknown";
+}
+
+void AutonAnalyzer::report(Auton id) {
+    printf("\n");
+    Timeline::writeJson(stdout, getName(id));
+    printf("\n");
+    if(!pros::c::usd_is_installed()) return;
+    FILE * f = fopen(reportPath, "a");
+    if(f == NULL) return;
+    Timeline::writeJson(f, getName(id));
+    fprintf(f, "\n");
+    fclose(f);
+}
+
+uint32_t AutonAnalyzer::simulate(Auton id, bool writeReport) {
+    /**
+     * The routine is run on a scheduler of its own, so simulating can't
+     * interrupt anything scheduled on the main one. Anything a simulation
+     * that was ended partway through left on it is cleared first, with the
+     * Timeline already simulating, so ending those commands doesn't touch
+     * the motors
+     */
+    static CommandScheduler simScheduler;
+    Timeline::setSimulating(true);
+    simScheduler.cancelAll();
+    CommandPool::reset();
+    Timeline::clear();
+    simScheduler.runToCompletion(buildRoutine(id));
+    uint32_t total = Timeline::now();
+    if(writeReport) report(id);
+    Timeline::setSimulating(false);
+    Timeline::clear();
+    return total;
+}
+
+uint32_t AutonAnalyzer::analyzeAll() {
+    //The report file is cleared first, so it only ever holds one full run of every routine
+    const Auton routines[] = {Auton::none, Auton::test, Auton::skills, Auton::midleft,
+                              Auton::midright, Auton::left, Auton::right};
+    if(pros::c::usd_is_installed()) {
+        FILE * f = fopen(reportPath, "w");
+        if(f != NULL) fclose(f);
+    }
+    uint32_t longest = 0;
+    for(Auton id : routines) {
+        uint32_t total = simulate(id, true);
+        if(total > longest) longest = total;
+    }
+    return longest;
+}
+
+/**
+ * A FreeRTOS mutex can't be freed by a task other than the one that took
+ * it, which is what PreArm::recover() has to do once PROS ends the disabled
+ * task, so the lock is a flag instead
+ */
+static std::atomic<bool> locked(false);
+
+bool AutonAnalyzer::tryLock() {
+    return !locked.exchange(true);
+}
+
+void AutonAnalyzer::lock() {
+    while(!tryLock()) pros::delay(5);
+}
+
+void AutonAnalyzer::unlock() {
+    locked = false;
+}
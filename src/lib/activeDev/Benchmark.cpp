@@ -0,0 +1,326 @@
+#include "main.h"
+#include <atomic>
+#include <new>
+
+/**
+ * The implementation of the Benchmark namespace
+ * This file contains the source code for the Benchmark functions, along with
+ * explanations of how each function works
+ */
+
+//The number of C++ heap allocations made since the program started
+static std::atomic<uint32_t> allocCount(0);
+
+/**
+ * The global operator new and delete are replaced so every C++ allocation is counted.
+ * They still use malloc and free, the same as the default ones
+ */
+void * operator new(size_t size) {
+    allocCount++;
+    void * p = malloc(size);
+    if(p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void * p) noexcept {
+    free(p);
+}
+
+void operator delete(void * p, size_t size) noexcept {
+    free(p);
+}
+
+uint32_t Benchmark::allocations() {
+    return allocCount;
+}
+
+//The results of the last run, and how many there are
+static Benchmark::Result results[Benchmark::maxResults];
+static int resultCount = 0;
+/**
+ * Written to by the benchmarks so the compiler can't throw away the work
+ * they do because the result is never used
+ */
+static volatile double sink;
+
+/**
+ * Stores a result, replacing the last result with the same name
+ */
+static void store(const Benchmark::Result & r) {
+    for(int i = 0; i < resultCount; i++) {
+        if(strcmp(results[i].name, r.name) == 0) {
+            results[i] = r;
+            return;
+        }
+    }
+    if(resultCount < Benchmark::maxResults) results[resultCount++] = r;
+}
+
+/**
+ * Runs fn once to warm up, so anything it only allocates on its first run
+ * (like printf's buffers) isn't counted, then times it over the given
+ * number of iterations. micros() only counts whole microseconds, so the
+ * iterations are chosen to make each benchmark take a few milliseconds
+ */
+template <typename F>
+static void measure(const char * name, uint32_t iterations, F fn) {
+    fn(0);
+    uint32_t allocStart = Benchmark::allocations();
+    uint64_t start = pros::c::micros();
+    for(uint32_t i = 0; i < iterations; i++) {
+        fn(i);
+    }
+    uint64_t elapsed = pros::c::micros() - start;
+    uint32_t allocs = Benchmark::allocations() - allocStart;
+    store({name, iterations, elapsed * 1000.0 / iterations, (double)allocs / iterations});
+}
+
+void Benchmark::measureOnce(const char * name, void (*fn)()) {
+    uint32_t allocStart = allocations();
+    uint64_t start = pros::c::micros();
+    fn();
+    uint64_t elapsed = pros::c::micros() - start;
+    store({name, 1, elapsed * 1000.0, (double)(allocations() - allocStart)});
+}
+
+int Benchmark::runAll() {
+    /**
+     * drive_pid is the math of one drivePID update: two PID controllers set
+     * up the same way TankDrive's are. updateMove itself isn't run, as it
+     * would move the robot
+     */
+    static PidController<double> leftPID(27, 0, 0, 0, 12000, 0.5);
+    static PidController<double> rightPID(27, 0, 0, 0, 12000, 0.5);
+    measure("drive_pid", 10000, [](uint32_t i) {
+        leftPID.setOutputLimit(12000);
+        rightPID.setOutputLimit(12000);
+        sink = leftPID.update(1000, i % 1000) + rightPID.update(1000, i % 1000);
+    });
+    /**
+     * driver_tick is the plan stage of one Pipeline tick of driver control,
+     * with nothing pressed, built the same way driverTick builds one. The
+     * outputs aren't flushed, so the benchmark can run at any time without
+     * fighting the control task or the Indexer for the motors. It is shaped
+     * by a TipGuard of its own, so the benchmark's ticks don't reset the real
+     * guard's last outputs or count towards its stats
+     */
+    static TipGuard tickGuard(3200, 2400, 4000, 5, 12);
+    measure("driver_tick", 1000, [](uint32_t i) {
+        Tasks::SensorFrame frame = Tasks::getSensorFrame();
+        frame.controller = {};
+        frame.indexer = indexer.getState();
+        sink = Pipeline::plan(frame, tickGuard).driveLeft;
+    });
+    /**
+     * tip_guard shapes a reversal from full forwards to full backwards and back
+     * every 5 ticks, the worst case, on a guard of its own
+     */
+    static TipGuard benchGuard(3200, 2400, 4000, 5, 12);
+    measure("tip_guard", 2000, [](uint32_t i) {
+        Tasks::SensorFrame frame = {};
+        frame.pitch = 3;
+        frame.roll = 1;
+        frame.time = 1000 + i * 20000ull;
+        MotorOutputs out = {};
+        out.driveLeft = out.driveRight = (i / 5) % 2 ? -127 : 127;
+        out.driveSet = true;
+        benchGuard.shape(frame, out);
+        sink = out.driveLeft;
+    });
+    /**
+     * ekf_update is one PoseEKF update from a made up frame 10 ms after the last,
+     * turning gently, on a filter of its own so the real one isn't disturbed
+     */
+    static PoseEKF benchEkf(drive);
+    measure("ekf_update", 2000, [](uint32_t i) {
+        Tasks::SensorFrame frame = {};
+        frame.leftVel = 100 + i % 10;
+        frame.rightVel = 90;
+        frame.yawRate = 20;
+        frame.forwardAccel = 0.01;
+        frame.time = 1000 + i * 10000ull;
+        benchEkf.update(frame);
+    });
+    /**
+     * plan_trajectory plans an S curve across two tiles, filled in every inch,
+     * with limits from the real drivetrain
+     */
+    static Trajectory benchTrajectory;
+    static const Trajectory::Point curve[] = {{0, 0}, {0, 12}, {6, 24}, {18, 30}, {24, 42}, {24, 54}};
+    Trajectory::Limits limits = Trajectory::limitsFor(drive, 80, 60);
+    measure("plan_trajectory", 50, [limits](uint32_t i) {
+        benchTrajectory.plan(curve, 6, 1, limits);
+        sink = benchTrajectory.getDuration();
+    });
+    //telemetry_label updates a hidden label, which is deleted afterwards
+    lv_obj_t * label = lv_label_create(lv_layer_top(), NULL);
+    lv_obj_set_hidden(label, true);
+    measure("telemetry_label", 200, [label](uint32_t i) {
+        Telemetry t = {1234.5678 + i, 2000, 150.25, 200, 45.5, 0.75};
+        GUI::updateTelemetryLabel(label, t);
+    });
+    lv_obj_del(label);
+
+    /**
+     * The baseline file has one line per benchmark: its name, ns/op and
+     * allocs/op. If there isn't one yet, these results become the baseline
+     */
+    bool usd = pros::c::usd_is_installed();
+    FILE * f = usd ? fopen(baselinePath, "r") : NULL;
+    char baseNames[maxResults][32];
+    double baseNs[maxResults];
+    double baseAllocs[maxResults];
+    int baseCount = 0;
+    if(f != NULL) {
+        while(baseCount < maxResults &&
+              fscanf(f, "%31s %lf %lf", baseNames[baseCount], &baseNs[baseCount], &baseAllocs[baseCount]) == 3) {
+            baseCount++;
+        }
+        fclose(f);
+    }
+    int failed = 0;
+    printf("\nBenchmark results (threshold %.0f%%):", threshold);
+    for(int i = 0; i < resultCount; i++) {
+        const Result & r = results[i];
+        const char * status = "new";
+        for(int j = 0; j < baseCount; j++) {
+            if(strcmp(baseNames[j], r.name) != 0) continue;
+            bool slower = r.nsPerOp > baseNs[j] * (1 + threshold / 100);
+            bool moreAllocs = r.allocsPerOp > baseAllocs[j];
+            status = slower || moreAllocs ? "FAIL" : "ok";
+            if(slower || moreAllocs) failed++;
+            break;
+        }
+        printf("\n%-16s %12.1f ns/op %8.2f allocs/op  %s", r.name, r.nsPerOp, r.allocsPerOp, status);
+    }
+    printf("\n");
+    if(usd && baseCount == 0) {
+        f = fopen(baselinePath, "w");
+        if(f != NULL) {
+            for(int i = 0; i < resultCount; i++) {
+                fprintf(f, "%s %f %f\n", results[i].name, results[i].nsPerOp, results[i].allocsPerOp);
+            }
+            fclose(f);
+            printf("Saved as the baseline\n");
+        }
+    }
+    return failed;
+}
+
+/**
+ * Runs one straight move the way DriveCommand does, at the scheduler's
+ * period, and prints the time from starting the move until updateMove
+ * reports it done, and the average error of the two sides 200 ms later,
+ * once the robot has come to rest. A move that hasn't finished after 5
+ * seconds is stopped and reported as it is
+ */
+static void timeMove(const char * name, double distance, MoveMode mode) {
+    double leftStart = drive.getLeftPosition();
+    double rightStart = drive.getRightPosition();
+    uint32_t start = pros::c::millis();
+    uint32_t now = start;
+    drive.startStraight(distance, mode);
+    while(!drive.updateMove() && pros::c::millis() - start < 5000) {
+        pros::c::task_delay_until(&now, CommandScheduler::period);
+    }
+    uint32_t settle = pros::c::millis() - start;
+    drive.endMove();
+    pros::delay(200);
+    double target = drive.inchesToDegrees(distance);
+    double error = ((drive.getLeftPosition() - leftStart - target) +
+                    (drive.getRightPosition() - rightStart - target)) / 2;
+    printf("\n%-8s %6.1f in  settled in %5u ms  final error %6.2f deg", name, distance,
+           (unsigned)settle, error);
+}
+
+void Benchmark::compareMoveModes(double distance) {
+    printf("\nMove mode comparison:");
+    timeMove("brain", distance, MoveMode::brain);
+    timeMove("brain", -distance, MoveMode::brain);
+    timeMove("onboard", distance, MoveMode::onboard);
+    timeMove("onboard", -distance, MoveMode::onboard);
+    printf("\n");
+}
+
+/**
+ * The made up run for compareParticleCounts: a 72 inch square driven at 24
+ * inches per second, with each corner turned over 15 steps, at the localizer's
+ * period of 50 ms. The odometry reads 3% long and turns 4% too far, which is
+ * about what wheel slip and scrub do, plus some noise
+ */
+static constexpr int simSteps = 1200;
+static constexpr double simSide = 72, simSpeed = 1.2;
+static const Pose simStart = {36, 24, 0};
+static uint32_t simRng = 1;
+
+static double simGaussian() {
+    double sum = 0;
+    for(int i = 0; i < 4; i++) {
+        simRng ^= simRng << 13;
+        simRng ^= simRng >> 17;
+        simRng ^= simRng << 5;
+        sum += (simRng >> 8) / 16777216.0;
+    }
+    return (sum - 2) * 1.7320508;
+}
+
+void Benchmark::compareParticleCounts() {
+    static const std::vector<Localizer::Sensor> sensors = {{0, -7, 0, 270}, {0, 7, 0, 90}, {0, 0, -7, 180}};
+    static Localizer sim(sensors, simStart);
+    const int counts[] = {50, 100, 200, 400};
+    printf("\nLocalizer particle count comparison (%d steps):", simSteps);
+    for(int n : counts) {
+        simRng = 1;
+        sim.setParticleCount(n);
+        sim.reset(simStart, 1);
+        Pose truth = simStart, odomPose = {0, 0, 0};
+        double totalError = 0, odomError = 0, error = 0;
+        uint64_t elapsed = 0;
+        int stepsOnSide = 0;
+        for(int k = 0; k < simSteps; k++) {
+            /**
+             * Drive along the side, or turn the corner once it has been
+             * driven, then move the odometry by the same step with its errors
+             */
+            double forward = 0, turn = 0;
+            if(stepsOnSide * simSpeed < simSide) {
+                forward = simSpeed;
+                stepsOnSide++;
+            }
+            else {
+                turn = 6;
+                if(++stepsOnSide * simSpeed >= simSide + 15 * simSpeed) stepsOnSide = 0;
+            }
+            double h = (truth.theta + turn / 2) * M_PI / 180;
+            truth.x += forward * sin(h);
+            truth.y += forward * cos(h);
+            truth.theta += turn;
+            double odomForward = forward * 1.03 + simGaussian() * 0.05;
+            double odomTurn = turn * 1.04 + simGaussian() * 0.1;
+            double oh = (odomPose.theta + odomTurn / 2) * M_PI / 180;
+            odomPose.x += odomForward * sin(oh);
+            odomPose.y += odomForward * cos(oh);
+            odomPose.theta += odomTurn;
+
+            double readings[3];
+            double th = truth.theta * M_PI / 180;
+            for(int s = 0; s < 3; s++) {
+                double sx = truth.x + sensors[s].x * cos(th) + sensors[s].y * sin(th);
+                double sy = truth.y - sensors[s].x * sin(th) + sensors[s].y * cos(th);
+                double d = Localizer::expectedDistance(sx, sy, truth.theta + sensors[s].angle);
+                readings[s] = d > Localizer::maxRange ? -1 : d + simGaussian() * std::max(0.6, 0.03 * d);
+            }
+            uint64_t start = pros::c::micros();
+            sim.step(odomPose, readings);
+            elapsed += pros::c::micros() - start;
+            Pose p = sim.getPose();
+            error = sqrt((p.x - truth.x) * (p.x - truth.x) + (p.y - truth.y) * (p.y - truth.y));
+            totalError += error;
+        }
+        Pose dead = sim.toField(odomPose);
+        odomError = sqrt((dead.x - truth.x) * (dead.x - truth.x) + (dead.y - truth.y) * (dead.y - truth.y));
+        printf("\n%4d particles  mean error %6.2f in  final error %6.2f in  (odometry %6.2f in)  %7.1f us/step",
+               n, totalError / simSteps, error, odomError, (double)elapsed / simSteps);
+    }
+    printf("\n");
+}
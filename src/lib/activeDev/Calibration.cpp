@@ -0,0 +1,97 @@
+#include "main.h"
+
+/**
+ * The implementation of the Calibration namespace
+ * This file contains the source code for the Calibration functions, along with
+ * explanations of how each function works
+ */
+
+//The drive's positions when startStraight was called, in degrees
+static double straightStartLeft = 0, straightStartRight = 0;
+
+bool Calibration::load() {
+    if(!pros::c::usd_is_installed()) return false;
+    FILE * f = fopen(path, "r");
+    if(f == NULL) return false;
+    /**
+     * The file is plain text, so it can be read and changed on a computer. A
+     * value that doesn't parse, or isn't positive, leaves the geometry in the
+     * TankDrive constructor alone
+     */
+    double diameter = 0, width = 0;
+    int read = fscanf(f, "%lf %lf", &diameter, &width);
+    fclose(f);
+    if(read != 2 || diameter <= 0 || width <= 0) return false;
+    drive.setGeometry(diameter, width);
+    return true;
+}
+
+bool Calibration::save() {
+    if(!pros::c::usd_is_installed()) return false;
+    FILE * f = fopen(path, "w");
+    if(f == NULL) return false;
+    fprintf(f, "%.4f %.4f\n", drive.getWheelDiameter(), drive.getBaseWidth());
+    fclose(f);
+    return true;
+}
+
+void Calibration::startStraight() {
+    //The sensor task keeps the drive's positions up to date, so they are only read here
+    straightStartLeft = drive.getLeftPosition();
+    straightStartRight = drive.getRightPosition();
+}
+
+double Calibration::finishStraight() {
+    /**
+     * Both sides travelled straightDistance inches, so their average is used.
+     * From startMove, degrees = inches * 360 / (diameter * pi), so
+     * diameter = inches * 360 / (degrees * pi). Less than half a rotation means
+     * the robot wasn't pushed, or the encoders aren't working
+     */
+    double degrees = ((drive.getLeftPosition() - straightStartLeft) +
+                      (drive.getRightPosition() - straightStartRight)) / 2;
+    if(degrees < 180) return 0;
+    double diameter = straightDistance * 360 / (degrees * 3.1415);
+    drive.setGeometry(diameter, drive.getBaseWidth());
+    return diameter;
+}
+
+double Calibration::calibrateTurn() {
+    if(!imu.isReady()) return 0;
+    //The caller holds the claim on the robot, so driver control is handed back before anything else can change it
+    bool wasDriverControl = Tasks::isDriverControl();
+    Tasks::setDriverControl(false);
+
+    /**
+     * The robot spins clockwise slowly, so the wheels don't slip, until the IMU
+     * reads the full number of turns. It then stops and is given half a second
+     * to come to rest before the end readings are taken, so the IMU and the
+     * encoders both include the last bit of coasting
+     */
+    double startLeft = drive.getLeftPosition();
+    double startRight = drive.getRightPosition();
+    double startAngle = imu.getRotation();
+    uint32_t start = pros::c::millis();
+    drive.setVoltage(4000, -4000);
+    while(imu.getRotation() - startAngle < 360 * turns && pros::c::millis() - start < turnTimeout) {
+        pros::delay(10);
+    }
+    drive.setVoltage(0, 0);
+    pros::delay(500);
+    double turned = imu.getRotation() - startAngle;
+    double leftInches = drive.degreesToInches(drive.getLeftPosition() - startLeft);
+    double rightInches = drive.degreesToInches(drive.getRightPosition() - startRight);
+    Tasks::setDriverControl(wasDriverControl);
+    if(turned < 360 * turns) return 0;
+
+    /**
+     * Each side rolls along a circle of diameter trackWidth around the middle of
+     * the robot, one forwards and one backwards, so the difference between them
+     * is trackWidth * the angle turned in radians (the same as Odometry::update)
+     */
+    double width = (leftInches - rightInches) / (turned * 3.1415 / 180);
+    if(width <= 0) return 0;
+    drive.setGeometry(drive.getWheelDiameter(), width);
+    save();
+    return width;
+}
@@ -0,0 +1,183 @@
+#include "main.h"
+
+/**
+ * The implementation of the ColorSorter class
+ * This file contains the source code for the ColorSorter class, along with
+ * explanations of how each function works
+ */
+
+ColorSorter::ColorSorter(Indexer & idx, uint8_t sensorPort, int gate, double distance, double speed)
+    : indexer(idx) {
+    port = sensorPort;
+    rejectColor = BallColor::none;
+    proximityGate = gate;
+    ejectDistance = distance;
+    ballSpeed = std::max(minBallSpeed, std::min(maxBallSpeed, speed));
+    carried = false;
+    currentBall = BallColor::none;
+    arriveTime = 0;
+    detectTime = 0;
+    ejectAt = 0;
+    plannedWait = 0;
+    ejectSent = 0;
+    ballsSeen = 0;
+    ballsRejected = 0;
+    latencyMin = UINT32_MAX;
+    latencyMax = 0;
+    latencyCount = 0;
+    latencyTotal = 0;
+    task = NULL;
+}
+
+void ColorSorter::start() {
+    //The LED is run at full brightness so the hue doesn't depend on the field lighting
+    pros::c::optical_set_led_pwm(port, 100);
+    if(task == NULL) {
+        task = pros::c::task_create(taskFn, this, Tasks::colorSorter.priority,
+                                    Tasks::colorSorter.stackDepth, Tasks::colorSorter.name);
+    }
+}
+
+BallColor ColorSorter::classify(double hue) {
+    /**
+     * Red wraps around 0 on the hue wheel, so anything within 30 degrees
+     * either side counts as red. Blue balls read between about 180 and 260
+     */
+    if(hue == PROS_ERR_F) return BallColor::none;
+    if(hue < 30 || hue > 330) return BallColor::red;
+    if(hue > 180 && hue < 260) return BallColor::blue;
+    return BallColor::none;
+}
+
+void ColorSorter::update() {
+    uint64_t now = pros::c::micros();
+    int32_t proximity = pros::c::optical_get_proximity(port);
+    bool present = proximity != PROS_ERR && proximity > proximityGate;
+
+    if(present && arriveTime == 0) {
+        //A ball has just arrived in front of the sensor
+        arriveTime = now;
+        currentBall = BallColor::none;
+        carried = true;
+    }
+    if(present && !indexer.isConveyorRunningUp()) carried = false;
+    if(present && currentBall == BallColor::none) {
+        /**
+         * The hue is read until it settles on red or blue, which is usually
+         * the first sample. Once the ball is classified, the eject is scheduled
+         * for when the ball will have climbed ejectDistance above the sensor,
+         * using the current estimate of ball speed
+         */
+        currentBall = classify(pros::c::optical_get_hue(port));
+        if(currentBall != BallColor::none) {
+            detectTime = now;
+            ballsSeen++;
+            BallColor reject = rejectColor;
+            if(reject != BallColor::none && currentBall == reject) {
+                plannedWait = ejectDistance / ballSpeed * 1000;
+                ejectAt = pros::c::millis() + plannedWait;
+                if(ejectAt == 0) ejectAt = 1;
+            }
+        }
+    }
+    if(!present && arriveTime != 0) {
+        /**
+         * The ball has just left the sensor. If the conveyor carried it past the
+         * whole time, it moved its own diameter in the time it was in front of the
+         * sensor, which gives its speed. A ball that was held at the sensor, or
+         * pushed past it by hand, says nothing about the conveyor, so it is left
+         * out. The estimate is smoothed and kept within the sane range, so one
+         * slipping ball doesn't throw off the next eject
+         */
+        double dwell = (now - arriveTime) / 1000000.0;
+        if(carried && dwell > 0.01) {
+            ballSpeed += 0.5 * (ballDiameter / dwell - ballSpeed);
+            ballSpeed = std::max(minBallSpeed, std::min(maxBallSpeed, ballSpeed));
+        }
+        arriveTime = 0;
+        currentBall = BallColor::none;
+    }
+    if(ejectAt != 0 && pros::c::millis() >= ejectAt) {
+        /**
+         * The conveyor runs backwards for long enough to carry the ball back
+         * down the ejectDistance it climbed, plus its own diameter, so it
+         * clears the sensor and drops out of the bottom of the conveyor
+         */
+        uint32_t time = (ejectDistance + ballDiameter) / ballSpeed * 1000;
+        ejectSent = detectTime;
+        indexer.eject(time);
+        ballsRejected++;
+        ejectAt = 0;
+    }
+    recordLatency();
+}
+
+void ColorSorter::recordLatency() {
+    /**
+     * Once the indexer has set the motors for an eject that was sent, the
+     * latency is the time from classification to actuation, minus the time
+     * the sorter planned to wait for the ball to reach the rollers. What is
+     * left is the time lost to sampling, scheduling and the indexer task
+     */
+    if(ejectSent == 0) return;
+    uint64_t actuated = indexer.getLastEjectTime();
+    if(actuated < ejectSent) return;
+    uint64_t planned = plannedWait * (uint64_t)1000;
+    uint64_t elapsed = actuated - ejectSent;
+    uint32_t latency = elapsed > planned ? elapsed - planned : 0;
+    if(latency < latencyMin) latencyMin = latency;
+    if(latency > latencyMax) latencyMax = latency;
+    latencyTotal += latency;
+    latencyCount++;
+    ejectSent = 0;
+}
+
+void ColorSorter::taskFn(void * param) {
+    ColorSorter * sorter = static_cast<ColorSorter *>(param);
+    int monitorId = TaskMonitor::add(Tasks::colorSorter.name, Tasks::colorSorter.stackDepth);
+    uint32_t now = pros::c::millis();
+    while(true) {
+        TaskMonitor::beginWork(monitorId);
+        sorter->update();
+        TaskMonitor::endWork(monitorId);
+        pros::c::task_delay_until(&now, period);
+    }
+}
+
+void ColorSorter::setRejectColor(BallColor color) {
+    rejectColor = color;
+}
+
+BallColor ColorSorter::getRejectColor() {
+    return rejectColor;
+}
+
+int ColorSorter::getBallsSeen() {
+    return ballsSeen;
+}
+
+int ColorSorter::getBallsRejected() {
+    return ballsRejected;
+}
+
+double ColorSorter::getBallSpeed() {
+    return ballSpeed;
+}
+
+uint32_t ColorSorter::getLatencyMin() {
+    return latencyCount == 0 ? 0 : latencyMin.load();
+}
+
+uint32_t ColorSorter::getLatencyMax() {
+    return latencyMax;
+}
+
+uint32_t ColorSorter::getLatencyMean() {
+    return latencyCount == 0 ? 0 : latencyTotal / latencyCount;
+}
+
+void ColorSorter::printReport() {
+    printf("[sorter] %d seen, %d rejected, %.1f in/s, detect to actuate latency min %u us, mean %u us, max %u us\n",
+           getBallsSeen(), getBallsRejected(), getBallSpeed(),
+           (unsigned)getLatencyMin(), (unsigned)getLatencyMean(), (unsigned)getLatencyMax());
+}
@@ -0,0 +1,298 @@
+#include "main.h"
+
+/**
+ * The implementation of the command framework
+ * This file contains the source code for the CommandPool, the group commands
+ * and the CommandScheduler, along with explanations of how each function works
+ */
+
+/**
+ * The memory the CommandPool hands out, and how much of it is in use.
+ * It is aligned to 8 bytes so any command (which may hold doubles) can be placed in it
+ */
+alignas(8) static uint8_t poolMemory[CommandPool::size];
+static size_t poolUsed = 0;
+static uint32_t poolGeneration = 0;
+
+void * CommandPool::allocate(size_t bytes, size_t align) {
+    //Round the start of the block up to the alignment the command needs
+    size_t start = (poolUsed + align - 1) & ~(align - 1);
+    if(start + bytes > size) {
+        printf("\nCommandPool: out of memory, a command was not created");
+        return NULL;
+    }
+    poolUsed = start + bytes;
+    return poolMemory + start;
+}
+
+void CommandPool::reset() {
+    CommandScheduler::cancelEverywhere();
+    poolUsed = 0;
+    poolGeneration++;
+}
+
+size_t CommandPool::used() {
+    return poolUsed;
+}
+
+uint32_t CommandPool::getGeneration() {
+    return poolGeneration;
+}
+
+void Command::start() {
+    timelineIndex = Timeline::begin(getName(), getKind());
+    initialize();
+}
+
+void Command::stop(bool interrupted) {
+    end(interrupted);
+    Timeline::finish(timelineIndex);
+}
+
+CommandGroup::CommandGroup(std::initializer_list<Command *> cmds) {
+    count = 0;
+    requirements = Subsystem::none;
+    for(Command * c : cmds) {
+        if(c == NULL || count >= maxCommands) continue;
+        commands[count] = c;
+        running[count] = false;
+        requirements |= c->getRequirements();
+        count++;
+    }
+}
+
+SequentialGroup::SequentialGroup(std::initializer_list<Command *> cmds) : CommandGroup(cmds), current(0) {
+    //Each command is told what follows it, so a drive move can tell if the next one takes over the motors
+    for(int i = 0; i + 1 < count; i++) commands[i]->setNext(commands[i + 1]);
+}
+
+void SequentialGroup::initialize() {
+    current = 0;
+    if(count > 0) commands[0]->start();
+}
+
+void SequentialGroup::execute() {
+    /**
+     * The current command is executed, and if it finishes, the next command
+     * starts and is executed in the same tick. Commands that finish straight
+     * away (like starting the intake) therefore don't cost a tick each
+     */
+    while(current < count) {
+        commands[current]->execute();
+        if(!commands[current]->isFinished()) break;
+        commands[current]->stop(false);
+        current++;
+        if(current < count) commands[current]->start();
+    }
+}
+
+bool SequentialGroup::isFinished() {
+    return current >= count;
+}
+
+void SequentialGroup::end(bool interrupted) {
+    if(interrupted && current < count) commands[current]->stop(true);
+}
+
+void ParallelGroup::initialize() {
+    for(int i = 0; i < count; i++) {
+        commands[i]->start();
+        running[i] = true;
+    }
+}
+
+void ParallelGroup::execute() {
+    for(int i = 0; i < count; i++) {
+        if(!running[i]) continue;
+        commands[i]->execute();
+        if(commands[i]->isFinished()) {
+            commands[i]->stop(false);
+            running[i] = false;
+        }
+    }
+}
+
+bool ParallelGroup::isFinished() {
+    for(int i = 0; i < count; i++) {
+        if(running[i]) return false;
+    }
+    return true;
+}
+
+void ParallelGroup::end(bool interrupted) {
+    /**
+     * Races and deadlines end while some of their commands are still running,
+     * so those commands are interrupted here whether or not the group was
+     */
+    for(int i = 0; i < count; i++) {
+        if(running[i]) {
+            commands[i]->stop(true);
+            running[i] = false;
+        }
+    }
+}
+
+bool RaceGroup::isFinished() {
+    for(int i = 0; i < count; i++) {
+        if(!running[i]) return true;
+    }
+    return count == 0;
+}
+
+bool DeadlineGroup::isFinished() {
+    return count == 0 || !running[0];
+}
+
+void WaitCommand::initialize() {
+    startTime = Timeline::now();
+}
+
+bool WaitCommand::isFinished() {
+    return Timeline::now() - startTime >= time;
+}
+
+/**
+ * Every scheduler that has been created, so CommandPool::reset() can reach
+ * them all. They are created once, as globals or function statics, so the
+ * list is never removed from
+ */
+static CommandScheduler * schedulers[CommandScheduler::maxSchedulers];
+static int schedulerCount = 0;
+
+CommandScheduler::CommandScheduler() {
+    count = 0;
+    cancelRequested = false;
+    firstTickTime = 0;
+    if(schedulerCount < maxSchedulers) schedulers[schedulerCount++] = this;
+}
+
+void CommandScheduler::cancelEverywhere() {
+    /**
+     * The commands are still in the pool at this point, so ending them is
+     * safe, and anything they were driving is stopped the usual way
+     */
+    for(int i = 0; i < schedulerCount; i++) {
+        schedulers[i]->cancelAll();
+    }
+}
+
+void CommandScheduler::remove(int i, bool interrupted) {
+    active[i]->stop(interrupted);
+    //Shift the rest of the commands down, keeping them in the order they were scheduled
+    for(int j = i; j < count - 1; j++) {
+        active[j] = active[j + 1];
+    }
+    count--;
+}
+
+void CommandScheduler::schedule(Command * cmd) {
+    if(cmd == NULL || isScheduled(cmd)) return;
+    //Interrupt anything using the same subsystems
+    for(int i = count - 1; i >= 0; i--) {
+        if(active[i]->getRequirements() & cmd->getRequirements()) remove(i, true);
+    }
+    if(count >= maxActive) {
+        printf("\nCommandScheduler: too many commands, a command was not scheduled");
+        return;
+    }
+    active[count++] = cmd;
+    cmd->start();
+}
+
+void CommandScheduler::run() {
+    for(int i = 0; i < count; i++) {
+        active[i]->execute();
+        if(active[i]->isFinished()) {
+            remove(i, false);
+            i--;
+        }
+    }
+}
+
+void CommandScheduler::cancel(Command * cmd) {
+    for(int i = 0; i < count; i++) {
+        if(active[i] == cmd) {
+            remove(i, true);
+            return;
+        }
+    }
+}
+
+void CommandScheduler::cancelAll() {
+    while(count > 0) {
+        remove(count - 1, true);
+    }
+}
+
+void CommandScheduler::requestCancel() {
+    cancelRequested = true;
+}
+
+bool CommandScheduler::isScheduled(Command * cmd) {
+    for(int i = 0; i < count; i++) {
+        if(active[i] == cmd) return true;
+    }
+    return false;
+}
+
+void CommandScheduler::runToCompletion(Command * cmd, int monitorId) {
+    /**
+     * task_delay_until keeps the ticks exactly one period apart, no matter
+     * how long each tick takes to run
+     */
+    /**
+     * A cancel requested before the routine started was meant for an earlier
+     * routine (or for none, if it came after that one had finished), so it is
+     * dropped. Only a cancel made while this routine runs stops it
+     */
+    cancelRequested = false;
+    schedule(cmd);
+    if(Timeline::isSimulating()) {
+        while(isScheduled(cmd)) {
+            run();
+            Timeline::advance(period);
+            if(Timeline::now() >= maxSimTime) cancel(cmd);
+        }
+        return;
+    }
+    uint32_t now = pros::c::millis();
+    bool firstTick = true;
+    while(isScheduled(cmd)) {
+        if(cancelRequested) {
+            cancelAll();
+            break;
+        }
+        TaskMonitor::beginWork(monitorId);
+        run();
+        TaskMonitor::endWork(monitorId);
+        if(firstTick) {
+            firstTickTime = pros::c::micros();
+            firstTick = false;
+        }
+        pros::c::task_delay_until(&now, period);
+    }
+}
+
+uint64_t CommandScheduler::getFirstTickTime() {
+    return firstTickTime;
+}
+
+Command * Commands::sequence(std::initializer_list<Command *> cmds) {
+    return makeCommand<SequentialGroup>(cmds);
+}
+
+Command * Commands::parallel(std::initializer_list<Command *> cmds) {
+    return makeCommand<ParallelGroup>(cmds);
+}
+
+Command * Commands::race(std::initializer_list<Command *> cmds) {
+    return makeCommand<RaceGroup>(cmds);
+}
+
+Command * Commands::deadline(std::initializer_list<Command *> cmds) {
+    return makeCommand<DeadlineGroup>(cmds);
+}
+
+Command * Commands::wait(uint32_t ms) {
+    return makeCommand<WaitCommand>(ms);
+}
@@ -7,7 +7,8 @@
  */ 
 
 Conveyor::Conveyor(std::initializer_list<int> ports, std::initializer_list<bool> revs, 
-                    pros::motor_gearset_e_t gearset, pros::controller_digital_e_t upBtn, pros::controller_digital_e_t downBtn) {
+                    pros::motor_gearset_e_t gearset, pros::controller_digital_e_t upBtn, pros::controller_digital_e_t downBtn)
+    : jam(ports) {
     motorPorts = ports;
     std::vector<bool> motorRevs = revs;
     for(int i = 0; i < motorPorts.size(); i++) {
@@ -19,27 +20,52 @@ Conveyor::Conveyor(std::initializer_list<int> ports, std::initializer_list<bool>
 }
 
 void Conveyor::driver(pros::controller_id_e_t controller) {
-    if(pros::c::controller_get_digital(controller, upButton)) moveUp();
-    else if (pros::c::controller_get_digital(controller, downButton)) moveDown();
-    else stop();
+    driver(ControllerState::read(controller));
+}
+
+void Conveyor::driver(const ControllerState & input) {
+    PROFILE_SCOPE("Conveyor::driver");
+    MotorOutputs out = {};
+    plan(input, out);
+    setPower(out.conveyor);
+}
+
+void Conveyor::plan(const ControllerState & input, MotorOutputs & out) const {
+    if(input.getDigital(upButton)) out.conveyor = 127;
+    else if (input.getDigital(downButton)) out.conveyor = -127;
+    else out.conveyor = 0;
+    out.conveyorSet = true;
+}
+
+void Conveyor::setPower(int power) {
+    jam.setPower(power);
+}
+
+int Conveyor::getPower() {
+    return jam.getPower();
 }
 
 void Conveyor::moveUp() {
-    for(int p : motorPorts) {
-        pros::c::motor_move(p, 127);
-    }
+    PROFILE_SCOPE("Conveyor::moveUp");
+    jam.setPower(127);
 }
 
 void Conveyor::moveDown() {
-    for(int p : motorPorts) {
-        pros::c::motor_move(p, -127);
-    }
+    PROFILE_SCOPE("Conveyor::moveDown");
+    jam.setPower(-127);
 }
 
 void Conveyor::stop() {
-    for(int p : motorPorts) {
-        pros::c::motor_move(p, 0);
-    }
+    PROFILE_SCOPE("Conveyor::stop");
+    jam.setPower(0);
+}
+
+std::vector<int> Conveyor::getMotorPorts() {
+    return motorPorts;
+}
+
+JamDetector & Conveyor::getJamDetector() {
+    return jam;
 }
 /**
 void Conveyor::updateTelemetry()
@@ -0,0 +1,227 @@
+#include "main.h"
+
+/**
+ * The implementation of the Indexer class
+ * This file contains the source code for the Indexer class, along with
+ * explanations of how each function works
+ */
+
+Indexer::Indexer(Intake & in, Conveyor & conv, uint8_t bottom, uint8_t middle, uint8_t top, int thresh)
+    : intake(in), conveyor(conv) {
+    bottomPort = bottom;
+    middlePort = middle;
+    topPort = top;
+    threshold = thresh;
+    state = IndexerState::idle;
+    requested = IndexerState::idle;
+    resumeState = IndexerState::idle;
+    requestCount = 0;
+    handledCount = 0;
+    ballsToShoot = 0;
+    ballsShot = 0;
+    topWasBlocked = false;
+    stateStart = 0;
+    stateTimeout = 0;
+    lastEjectTime = 0;
+    task = NULL;
+}
+
+void Indexer::start() {
+    /**
+     * adi_analog_calibrate averages the line tracker's reading over about
+     * half a second, and adi_analog_read_calibrated then returns readings
+     * relative to that average. So the conveyor must be empty while this runs
+     */
+    for(uint8_t p : {bottomPort, middlePort, topPort}) {
+        pros::c::adi_port_set_config(p, pros::E_ADI_ANALOG_IN);
+        pros::c::adi_analog_calibrate(p);
+    }
+    if(task == NULL) {
+        task = pros::c::task_create(taskFn, this, Tasks::indexer.priority,
+                                    Tasks::indexer.stackDepth, Tasks::indexer.name);
+    }
+}
+
+bool Indexer::ballAtBottom() {
+    return pros::c::adi_analog_read_calibrated(bottomPort) < -threshold;
+}
+
+bool Indexer::ballAtMiddle() {
+    return pros::c::adi_analog_read_calibrated(middlePort) < -threshold;
+}
+
+bool Indexer::ballAtTop() {
+    return pros::c::adi_analog_read_calibrated(topPort) < -threshold;
+}
+
+void Indexer::enterState(IndexerState s) {
+    /**
+     * Motors are only set when a state is entered (except for intaking,
+     * which starts and stops the conveyor as balls arrive), so the indexer doesn't
+     * flood the motors with the same command every update
+     */
+    if(s == IndexerState::ejecting && state != IndexerState::ejecting) resumeState = state;
+    state = s;
+    stateStart = pros::c::millis();
+    switch(s)
+    {
+        case IndexerState::intaking:
+            intake.in();
+            break;
+        case IndexerState::holding:
+            intake.stop();
+            conveyor.stop();
+            break;
+        case IndexerState::shooting:
+            topWasBlocked = ballAtTop();
+            intake.in();
+            conveyor.moveUp();
+            break;
+        case IndexerState::ejecting:
+            intake.out();
+            conveyor.moveDown();
+            lastEjectTime = pros::c::micros();
+            break;
+        case IndexerState::idle:
+            break;
+    }
+}
+
+void Indexer::update() {
+    /**
+     * Move to a state requested by another task first. The count is read
+     * before the state, so a request made while this one is being entered
+     * still differs from handledCount afterwards and is picked up next update
+     */
+    uint32_t requests = requestCount;
+    if(requests != handledCount) {
+        enterState(requested);
+        handledCount = requests;
+    }
+    bool topBlocked = ballAtTop();
+    switch(state)
+    {
+        case IndexerState::intaking:
+            /**
+             * Balls are moved up until one reaches the top line tracker, then
+             * the conveyor stops so that ball isn't shot by accident. Once all
+             * three line trackers see a ball, the conveyor is full and the intake stops too
+             */
+            if(topBlocked) conveyor.stop();
+            else conveyor.moveUp();
+            if(topBlocked && ballAtMiddle() && ballAtBottom()) enterState(IndexerState::holding);
+            break;
+        case IndexerState::shooting:
+            /**
+             * A ball has been scored when the top line tracker goes from blocked to
+             * clear, i.e. the ball has just left the top of the conveyor. The state
+             * ends as soon as the last requested ball has left, or when the timeout runs out
+             */
+            if(topWasBlocked && !topBlocked) {
+                ballsShot++;
+                ballsToShoot--;
+            }
+            if(ballsToShoot <= 0 || pros::c::millis() - stateStart > stateTimeout) {
+                enterState(IndexerState::holding);
+            }
+            break;
+        case IndexerState::ejecting:
+            if(pros::c::millis() - stateStart > stateTimeout) {
+                //Stopping the motors before handing them back, in case the indexer was idle
+                intake.stop();
+                conveyor.stop();
+                enterState(resumeState);
+            }
+            break;
+        case IndexerState::holding:
+        case IndexerState::idle:
+            break;
+    }
+    topWasBlocked = topBlocked;
+}
+
+void Indexer::taskFn(void * param) {
+    /**
+     * The task sleeps for up to one period, but request() wakes it with a
+     * task notification, so a new request (like an eject from the ColorSorter)
+     * reaches the motors without waiting out the rest of the period
+     */
+    Indexer * indexer = static_cast<Indexer *>(param);
+    int monitorId = TaskMonitor::add(Tasks::indexer.name, Tasks::indexer.stackDepth);
+    while(true) {
+        TaskMonitor::beginWork(monitorId);
+        indexer->update();
+        TaskMonitor::endWork(monitorId);
+        pros::c::task_notify_take(true, period);
+    }
+}
+
+void Indexer::request(IndexerState s) {
+    requested = s;
+    requestCount++;
+    if(task != NULL) pros::c::task_notify(task);
+}
+
+void Indexer::intakeBalls() {
+    request(IndexerState::intaking);
+}
+
+void Indexer::hold() {
+    request(IndexerState::holding);
+}
+
+void Indexer::shoot(int balls, uint32_t timeout) {
+    ballsToShoot = balls;
+    stateTimeout = timeout;
+    request(IndexerState::shooting);
+}
+
+bool Indexer::score(int balls, uint32_t timeout) {
+    /**
+     * score() starts shooting, then waits for the indexer task to pick up
+     * the request and finish it. The indexer leaves the shooting state either
+     * when every ball is through or when the timeout runs out
+     */
+    shoot(balls, timeout);
+    while(isShooting()) {
+        pros::delay(period);
+    }
+    return ballsToShoot <= 0;
+}
+
+void Indexer::eject(uint32_t time) {
+    stateTimeout = time;
+    request(IndexerState::ejecting);
+}
+
+void Indexer::stop() {
+    request(IndexerState::idle);
+}
+
+IndexerState Indexer::getState() {
+    return state;
+}
+
+bool Indexer::isShooting() {
+    /**
+     * Whether a request is pending is read before the state. The new state is
+     * published before the request stops being pending, so if it has stopped,
+     * the state read after it is already the new one
+     */
+    bool pending = requestCount != handledCount;
+    bool requestedShooting = requested == IndexerState::shooting;
+    return (pending && requestedShooting) || state == IndexerState::shooting;
+}
+
+int Indexer::getBallsShot() {
+    return ballsShot;
+}
+
+bool Indexer::isConveyorRunningUp() {
+    JamDetector & jams = conveyor.getJamDetector();
+    return conveyor.getPower() > 0 && !jams.isUnjamming() && !jams.hasGivenUp();
+}
+
+uint64_t Indexer::getLastEjectTime() {
+    return lastEjectTime;
+}
@@ -0,0 +1,82 @@
+#include "main.h"
+
+/**
+ * The implementation of the Inertial class
+ * This file contains the source code for the Inertial class, along with
+ * explanations of how each function works
+ */
+
+Inertial::Inertial(uint8_t imuPort) {
+    port = imuPort;
+    calibrationStarted = false;
+}
+
+bool Inertial::calibrate() {
+    /**
+     * imu_reset returns PROS_ERR with errno EAGAIN if a calibration is already
+     * running, which still counts as started. Any other error means there is
+     * no IMU on the port, so it is tried again the next time
+     */
+    if(calibrationStarted) return true;
+    if(pros::c::imu_reset(port) != PROS_ERR || errno == EAGAIN) calibrationStarted = true;
+    return calibrationStarted;
+}
+
+bool Inertial::isReady() {
+    /**
+     * imu_get_status returns E_IMU_STATUS_ERROR when the port has no IMU, which
+     * also has the calibrating bit set, so it is checked first
+     */
+    if(!calibrationStarted) return false;
+    pros::c::imu_status_e_t status = pros::c::imu_get_status(port);
+    if(status == pros::c::E_IMU_STATUS_ERROR) return false;
+    return (status & pros::c::E_IMU_STATUS_CALIBRATING) == 0;
+}
+
+double Inertial::getHeading() {
+    if(!isReady()) return PROS_ERR_F;
+    return pros::c::imu_get_heading(port);
+}
+
+double Inertial::getPitch() {
+    /**
+     * The IMU's roll is about its x axis, which points across the robot, so
+     * it is the robot's pitch. A rotation about x that is positive by the
+     * right hand rule lifts the y axis, the front, towards z
+     */
+    if(!isReady()) return PROS_ERR_F;
+    return pitchSign * pros::c::imu_get_roll(port);
+}
+
+double Inertial::getRoll() {
+    /**
+     * The IMU's pitch is about its y axis, which points forwards, so it is
+     * the robot's roll. A rotation about y that is positive by the right hand
+     * rule tips z towards x, the right side, so the right side goes down
+     */
+    if(!isReady()) return PROS_ERR_F;
+    return rollSign * pros::c::imu_get_pitch(port);
+}
+
+double Inertial::getRotation() {
+    if(!isReady()) return PROS_ERR_F;
+    return pros::c::imu_get_rotation(port);
+}
+
+double Inertial::getYawRate() {
+    /**
+     * The IMU's axes are right handed with z pointing up, so its z rate is
+     * positive counterclockwise, the opposite way to the heading
+     */
+    if(!isReady()) return PROS_ERR_F;
+    return -pros::c::imu_get_gyro_rate(port).z;
+}
+
+double Inertial::getForwardAccel() {
+    if(!isReady()) return PROS_ERR_F;
+    return pros::c::imu_get_accel(port).y;
+}
+
+uint8_t Inertial::getPort() {
+    return port;
+}
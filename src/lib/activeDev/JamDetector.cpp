@@ -0,0 +1,163 @@
+#include "main.h"
+
+/**
+ * The implementation of the JamDetector class
+ * This file contains the source code for the JamDetector class, along with
+ * explanations of how each function works
+ */
+
+JamDetector::JamDetector(const std::vector<int> & ports)
+    : motorPorts(ports), commanded(0), unjamming(false), givenUp(false), givenUpPower(0),
+      jams(0), repeats(0), giveUps(0), lastPort(0) {
+    lastCommanded = 0;
+    stallStart = 0;
+    checkFrom = 0;
+    reverseUntil = 0;
+    lastUnjam = 0;
+    repeatRun = 0;
+}
+
+void JamDetector::configure(const Thresholds & t) {
+    thresholds = t;
+}
+
+JamDetector::Thresholds JamDetector::getThresholds() {
+    return thresholds;
+}
+
+void JamDetector::write(int power) {
+    for(int p : motorPorts) {
+        pros::c::motor_move(p, power);
+    }
+}
+
+void JamDetector::setPower(int power) {
+    /**
+     * While a jam is being cleared, the power is only remembered, and the jam
+     * task sends it when the cycle ends. If the cycle ends between the check
+     * and the write, the power is sent a little early, which is harmless. The
+     * power the detector gave up on isn't sent at all, but any other power is,
+     * and the jam task starts checking again when it sees it
+     */
+    commanded = power;
+    if(unjamming) return;
+    if(givenUp && power == givenUpPower) return;
+    write(power);
+}
+
+int JamDetector::findStall() {
+    /**
+     * The current limit flag is checked as well as the current itself, as the
+     * PowerManager may have limited a motor to less than stallCurrent. A motor
+     * that doesn't answer is never taken as stalled
+     */
+    for(int p : motorPorts) {
+        double velocity = pros::c::motor_get_actual_velocity(p);
+        if(velocity == PROS_ERR_F || fabs(velocity) >= thresholds.stallVelocity) continue;
+        int32_t current = pros::c::motor_get_current_draw(p);
+        bool limited = pros::c::motor_is_over_current(p) == 1;
+        if((current != PROS_ERR && current > thresholds.stallCurrent) || limited) return p;
+    }
+    return 0;
+}
+
+void JamDetector::update(bool paused) {
+    PROFILE_SCOPE("JamDetector::update");
+    uint32_t now = pros::c::millis();
+    int power = commanded;
+
+    /**
+     * The unjam cycle ends when its time is up, or early if the mechanism is
+     * stopped or sent the other way, as whoever is driving it has already
+     * dealt with the ball. Either way, the motors go back to the last power
+     * they were given, and get spinUpTime to get back up to speed. Until then
+     * the reverse power is sent every update, so a setPower that raced with
+     * the start of the cycle only holds for one update
+     */
+    if(unjamming) {
+        bool sameWay = (power > 0) == (lastCommanded > 0) && abs(power) >= thresholds.minPower;
+        if(now < reverseUntil && sameWay) {
+            write(lastCommanded > 0 ? -thresholds.reversePower : thresholds.reversePower);
+            return;
+        }
+        write(power);
+        unjamming = false;
+        lastUnjam = now;
+        checkFrom = now + thresholds.spinUpTime;
+        stallStart = 0;
+        lastCommanded = power;
+        return;
+    }
+
+    /**
+     * A new power restarts the wait, so starting up against a ball isn't a
+     * jam, and ends a give up, as whoever is driving the mechanism has done
+     * something about it. setPower has already sent it
+     */
+    if(power != lastCommanded) {
+        lastCommanded = power;
+        checkFrom = now + thresholds.spinUpTime;
+        stallStart = 0;
+        repeatRun = 0;
+        givenUp = false;
+    }
+    if(givenUp) return;
+    //While paused, the wait is started again every update, so it runs from when the pause ends
+    if(paused) {
+        checkFrom = now + thresholds.spinUpTime;
+        stallStart = 0;
+        return;
+    }
+    if(abs(power) < thresholds.minPower || now < checkFrom) {
+        stallStart = 0;
+        return;
+    }
+
+    int port = findStall();
+    if(port == 0) {
+        stallStart = 0;
+        return;
+    }
+    if(stallStart == 0) stallStart = now;
+    if(now - stallStart < thresholds.jamTime) return;
+
+    /**
+     * A jam: the motors are run the other way from how they were being driven,
+     * unless it is the maxRepeats-th repeat in a row, in which case the motors
+     * are stopped instead, and left stopped until the power changes
+     */
+    jams++;
+    lastPort = port;
+    if(lastUnjam != 0 && now - lastUnjam < repeatTime) {
+        repeats++;
+        repeatRun++;
+    }
+    else repeatRun = 0;
+    if(repeatRun >= thresholds.maxRepeats) {
+        giveUps++;
+        repeatRun = 0;
+        givenUpPower = power;
+        givenUp = true;
+        write(0);
+        return;
+    }
+    unjamming = true;
+    reverseUntil = now + thresholds.reverseTime;
+    write(power > 0 ? -thresholds.reversePower : thresholds.reversePower);
+}
+
+int JamDetector::getPower() {
+    return commanded;
+}
+
+bool JamDetector::isUnjamming() {
+    return unjamming;
+}
+
+bool JamDetector::hasGivenUp() {
+    return givenUp;
+}
+
+JamDetector::Stats JamDetector::getStats() {
+    return {jams, repeats, giveUps, lastPort};
+}
@@ -0,0 +1,327 @@
+#include "main.h"
+#include <cmath>
+
+/**
+ * The implementation of the Localizer class
+ * This file contains the source code for the Localizer class, along with
+ * explanations of how each function works
+ */
+
+/**
+ * The spread of the particles' headings after a reset, in radians (about 2 degrees),
+ * and the largest movement between two updates that is taken as real movement rather
+ * than the odometry being reset, in inches and radians
+ */
+static constexpr float resetHeadingSpread = 0.035f;
+static constexpr double maxStepDistance = 12;
+static constexpr double maxStepTurn = M_PI / 4;
+
+/**
+ * The distance from (x, y) along the direction (dx, dy) to the nearest wall of the
+ * field. The ray leaves through whichever of the x and y walls in front of it it reaches
+ * first. A point outside the field gives 0, so its particle matches nothing
+ */
+static inline float wallDistance(float x, float y, float dx, float dy) {
+    constexpr float size = Localizer::fieldSize;
+    float tx = dx > 1e-6f ? (size - x) / dx : dx < -1e-6f ? -x / dx : 1e9f;
+    float ty = dy > 1e-6f ? (size - y) / dy : dy < -1e-6f ? -y / dy : 1e9f;
+    float t = tx < ty ? tx : ty;
+    return t > 0 ? t : 0;
+}
+
+Localizer::Localizer(const std::vector<Sensor> & sensorList, Pose start, int particles)
+    : resetRequested(false), published({start, 0, false}) {
+    sensorCount = 0;
+    for(const Sensor & s : sensorList) {
+        if(sensorCount == maxSensors) break;
+        sensors[sensorCount++] = s;
+    }
+    setParticleCount(particles);
+    count = nextCount;
+    current = 0;
+    started = false;
+    lastOdom = {0, 0, 0};
+    startPose = start;
+    origin = start;
+    resetPose = start;
+    resetSpread = 1;
+    correctionPending = false;
+    pendingCorrection = {0, 0, 0};
+    seenCorrections = 0;
+    rng = 0x2545F491;
+    scatter();
+}
+
+float Localizer::uniform() {
+    //A xorshift generator, which is fast and plenty random enough for this
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (rng >> 8) * (1.0f / 16777216);
+}
+
+float Localizer::gaussian() {
+    /**
+     * The sum of 4 uniform numbers is close to a normal distribution, with a
+     * mean of 2 and a variance of 4/12, and needs no sin, cos or log
+     */
+    return (uniform() + uniform() + uniform() + uniform() - 2) * 1.7320508f;
+}
+
+void Localizer::scatter() {
+    float * x = xs[current];
+    float * y = ys[current];
+    float * h = headings[current];
+    float theta = resetPose.theta * M_PI / 180;
+    for(int i = 0; i < count; i++) {
+        x[i] = resetPose.x + gaussian() * resetSpread;
+        y[i] = resetPose.y + gaussian() * resetSpread;
+        h[i] = theta + gaussian() * resetHeadingSpread;
+        weights[i] = 1.0f / count;
+    }
+}
+
+void Localizer::reset() {
+    reset(startPose);
+}
+
+void Localizer::reset(Pose start, double spread) {
+    //The same hand over as Odometry::reset, as only the localizer task changes the particles
+    resetPose = start;
+    resetSpread = spread;
+    resetRequested = true;
+}
+
+bool Localizer::step(Pose odomPose, const double * readings) {
+    PROFILE_SCOPE("Localizer::step");
+    if(resetRequested) {
+        count = nextCount;
+        origin = resetPose;
+        scatter();
+        started = false;
+        correctionPending = false;
+        resetRequested = false;
+    }
+    if(!started) {
+        lastOdom = odomPose;
+        started = true;
+    }
+
+    /**
+     * The odometry's movement since the last step is turned into a distance
+     * forwards and to the right of the robot, and a turn. That is the same
+     * for every particle, wherever it is on the field, so each one is moved
+     * along its own heading by it. A movement bigger than the robot could make
+     * in one step is the odometry being reset, so it is left out
+     */
+    double dx = odomPose.x - lastOdom.x;
+    double dy = odomPose.y - lastOdom.y;
+    double dTheta = (odomPose.theta - lastOdom.theta) * M_PI / 180;
+    double mid = lastOdom.theta * M_PI / 180 + dTheta / 2;
+    double forward = dx * sin(mid) + dy * cos(mid);
+    double right = dx * cos(mid) - dy * sin(mid);
+    lastOdom = odomPose;
+    if(fabs(forward) > maxStepDistance || fabs(right) > maxStepDistance || fabs(dTheta) > maxStepTurn) {
+        forward = 0;
+        right = 0;
+        dTheta = 0;
+    }
+    float moveSd = moveNoiseScale * sqrt(forward * forward + right * right) + moveNoise;
+    float turnSd = turnNoiseScale * fabs(dTheta) + turnNoise;
+
+    float * x = xs[current];
+    float * y = ys[current];
+    float * h = headings[current];
+    for(int i = 0; i < count; i++) {
+        float turn = dTheta + gaussian() * turnSd;
+        float f = forward + gaussian() * moveSd;
+        float r = right + gaussian() * moveSd;
+        float m = h[i] + turn / 2;
+        float s = sinf(m), c = cosf(m);
+        x[i] += f * s + r * c;
+        y[i] += f * c - r * s;
+        h[i] += turn;
+        sins[i] = sinf(h[i]);
+        coss[i] = cosf(h[i]);
+    }
+
+    /**
+     * Each reading multiplies every particle's weight by how likely it is from
+     * that particle: a bell curve around the distance to the wall, plus a small
+     * chance for anything else. The sensor's place on the robot and the way it
+     * points are turned by the particle's heading using the sin and cos worked
+     * out above, so there are no more trig functions per sensor
+     */
+    bool sensed = false;
+    for(int s = 0; s < sensorCount; s++) {
+        if(readings[s] < 0) continue;
+        sensed = true;
+        float z = readings[s];
+        float sd = std::max(minReadingNoise, readingNoiseScale * z);
+        float inv2Var = 1 / (2 * sd * sd);
+        float mx = sensors[s].x, my = sensors[s].y;
+        float sa = sin(sensors[s].angle * M_PI / 180), ca = cos(sensors[s].angle * M_PI / 180);
+        for(int i = 0; i < count; i++) {
+            float sh = sins[i], ch = coss[i];
+            float sx = x[i] + mx * ch + my * sh;
+            float sy = y[i] - mx * sh + my * ch;
+            float dirX = sh * ca + ch * sa;
+            float dirY = ch * ca - sh * sa;
+            float e = z - wallDistance(sx, sy, dirX, dirY);
+            weights[i] *= (1 - (float)unexpectedChance) * expf(-e * e * inv2Var) + (float)unexpectedChance;
+        }
+    }
+
+    /**
+     * If no particle matches the readings at all, they are all equally wrong,
+     * so the readings tell the filter nothing and are left out
+     */
+    float total = 0;
+    for(int i = 0; i < count; i++) total += weights[i];
+    if(total < 1e-30f) {
+        for(int i = 0; i < count; i++) weights[i] = 1.0f / count;
+        sensed = false;
+    }
+    else {
+        for(int i = 0; i < count; i++) weights[i] /= total;
+    }
+
+    published.write(estimate(sensed));
+
+    /**
+     * 1 / the sum of the squared weights is roughly how many particles are
+     * carrying the weight. Resampling every step would throw away the spread
+     * the filter needs, so it is only done once that falls below half
+     */
+    float sumSq = 0;
+    for(int i = 0; i < count; i++) sumSq += weights[i] * weights[i];
+    if(sensed && sumSq * count > 2) resample();
+    return sensed;
+}
+
+Localizer::Estimate Localizer::estimate(bool sensed) {
+    /**
+     * The heading is averaged as a direction (the average of the sins and the
+     * cosines) so headings either side of 0 don't average out to 180
+     */
+    const float * x = xs[current];
+    const float * y = ys[current];
+    float mx = 0, my = 0, ms = 0, mc = 0;
+    for(int i = 0; i < count; i++) {
+        mx += weights[i] * x[i];
+        my += weights[i] * y[i];
+        ms += weights[i] * sins[i];
+        mc += weights[i] * coss[i];
+    }
+    float variance = 0;
+    for(int i = 0; i < count; i++) {
+        float ex = x[i] - mx, ey = y[i] - my;
+        variance += weights[i] * (ex * ex + ey * ey);
+    }
+    double heading = atan2(ms, mc) * 180 / M_PI;
+    if(heading < 0) heading += 360;
+    return {{mx, my, heading}, sqrt(variance), sensed};
+}
+
+void Localizer::resample() {
+    /**
+     * Systematic resampling: count evenly spaced points, starting from one
+     * random offset, are laid along the running total of the weights, and
+     * each point picks the particle whose weight it lands in. It takes one
+     * pass, and keeps particles in proportion to their weights with less
+     * randomness than drawing each one on its own
+     */
+    int next = 1 - current;
+    float step = 1.0f / count;
+    float point = uniform() * step;
+    float sum = weights[0];
+    int j = 0;
+    for(int i = 0; i < count; i++) {
+        while(point > sum && j < count - 1) sum += weights[++j];
+        xs[next][i] = xs[current][j];
+        ys[next][i] = ys[current][j];
+        headings[next][i] = headings[current][j];
+        point += step;
+    }
+    for(int i = 0; i < count; i++) weights[i] = step;
+    current = next;
+}
+
+void Localizer::update() {
+    PROFILE_SCOPE("Localizer::update");
+    /**
+     * Once the odometry has added the last correction, the pose the particles
+     * were last moved to is moved by it too, so the jump isn't taken as movement
+     */
+    Pose odomPose = odom.getPose();
+    if(correctionPending && odom.getCorrections() != seenCorrections) {
+        lastOdom.x += pendingCorrection.x;
+        lastOdom.y += pendingCorrection.y;
+        lastOdom.theta += pendingCorrection.theta;
+        correctionPending = false;
+    }
+
+    /**
+     * The Distance sensor reads in millimeters, and its confidence is only
+     * measured beyond 200 mm, so closer readings are always used
+     */
+    double readings[maxSensors];
+    for(int s = 0; s < sensorCount; s++) {
+        int32_t mm = pros::c::distance_get(sensors[s].port);
+        readings[s] = -1;
+        if(mm == PROS_ERR || mm <= 0 || mm / 25.4 > maxRange) continue;
+        if(mm > 200 && pros::c::distance_get_confidence(sensors[s].port) < minConfidence) continue;
+        readings[s] = mm / 25.4;
+    }
+    if(!step(odomPose, readings) || correctionPending) return;
+
+    //The odometry is only moved once the particles agree, and by more than their noise
+    Estimate e = published.read();
+    if(e.spread > maxCorrectionSpread) return;
+    Pose target = toOdom(e.pose);
+    Pose change = {target.x - odomPose.x, target.y - odomPose.y, wrap180(target.theta - odomPose.theta)};
+    if(fabs(change.x) < correctionMin && fabs(change.y) < correctionMin && fabs(change.theta) < correctionMinAngle) return;
+    seenCorrections = odom.getCorrections();
+    if(odom.correct(change)) {
+        pendingCorrection = change;
+        correctionPending = true;
+    }
+}
+
+Pose Localizer::toField(Pose odomPose) {
+    /**
+     * The odometry's x and y are turned by the starting heading, then moved
+     * to the starting position. toOdom does the opposite
+     */
+    double t = origin.theta * M_PI / 180;
+    return {origin.x + odomPose.x * cos(t) + odomPose.y * sin(t),
+            origin.y - odomPose.x * sin(t) + odomPose.y * cos(t),
+            origin.theta + odomPose.theta};
+}
+
+Pose Localizer::toOdom(Pose fieldPose) {
+    double t = origin.theta * M_PI / 180;
+    double dx = fieldPose.x - origin.x, dy = fieldPose.y - origin.y;
+    return {dx * cos(t) - dy * sin(t), dx * sin(t) + dy * cos(t), fieldPose.theta - origin.theta};
+}
+
+double Localizer::expectedDistance(double x, double y, double heading) {
+    double h = heading * M_PI / 180;
+    return wallDistance(x, y, sin(h), cos(h));
+}
+
+Localizer::Estimate Localizer::getEstimate() {
+    return published.read();
+}
+
+Pose Localizer::getPose() {
+    return published.read().pose;
+}
+
+void Localizer::setParticleCount(int particles) {
+    nextCount = std::max(1, std::min(particles, maxParticles));
+}
+
+int Localizer::getParticleCount() {
+    return count;
+}
@@ -0,0 +1,94 @@
+#include "main.h"
+#include <cmath>
+
+/**
+ * The implementation of the Odometry class
+ * This file contains the source code for the Odometry class, along with
+ * explanations of how each function works
+ */
+
+Odometry::Odometry(TankDrive & d) : drive(d), published({0, 0, 0}), resetRequested(false),
+                                    correctionRequested(false), corrections(0) {
+    lastLeft = 0;
+    lastRight = 0;
+    started = false;
+    x = 0;
+    y = 0;
+    theta = 0;
+    resetPose = {0, 0, 0};
+    correction = {0, 0, 0};
+}
+
+void Odometry::update(double leftDeg, double rightDeg) {
+    if(resetRequested) {
+        x = resetPose.x;
+        y = resetPose.y;
+        theta = resetPose.theta * M_PI / 180;
+        resetRequested = false;
+        //A correction asked for before the reset was for the old pose, so it is dropped
+        correctionRequested = false;
+        published.write(resetPose);
+    }
+    if(correctionRequested) {
+        x += correction.x;
+        y += correction.y;
+        theta += correction.theta * M_PI / 180;
+        corrections++;
+        correctionRequested = false;
+    }
+    /**
+     * The positions are fused from every encoder on each side, so a side with
+     * an encoder unplugged keeps counting from the others, and one with none
+     * working holds still rather than jumping (see TankDrive::updateEncoders)
+     */
+    if(!started) {
+        lastLeft = leftDeg;
+        lastRight = rightDeg;
+        started = true;
+    }
+    /**
+     * Over one 10 ms update the robot moves along a short arc. The heading
+     * changes by the difference between the sides over the width of the base
+     * (the same arc length relation turnAngle uses, turned around), and the
+     * distance moved is the average of the two sides. Moving that distance
+     * along the heading halfway through the arc is very close to the real arc
+     */
+    double leftIn = drive.degreesToInches(leftDeg - lastLeft);
+    double rightIn = drive.degreesToInches(rightDeg - lastRight);
+    lastLeft = leftDeg;
+    lastRight = rightDeg;
+    double dTheta = (leftIn - rightIn) / drive.getBaseWidth();
+    double distance = (leftIn + rightIn) / 2;
+    double midTheta = theta + dTheta / 2;
+    x += distance * sin(midTheta);
+    y += distance * cos(midTheta);
+    theta += dTheta;
+    published.write({x, y, theta * 180 / M_PI});
+}
+
+void Odometry::reset(Pose start) {
+    /**
+     * The pose is only ever changed by the odometry task, so reset() leaves
+     * the new pose for it to pick up. resetRequested is set after resetPose,
+     * so the odometry task never sees a half written pose. Only the odometry
+     * task writes the published pose, as a DoubleBuffer only allows one writer
+     */
+    resetPose = start;
+    resetRequested = true;
+}
+
+bool Odometry::correct(Pose change) {
+    //Handed over to the odometry task the same way as reset()
+    if(correctionRequested) return false;
+    correction = change;
+    correctionRequested = true;
+    return true;
+}
+
+uint32_t Odometry::getCorrections() {
+    return corrections;
+}
+
+Pose Odometry::getPose() {
+    return published.read();
+}
@@ -0,0 +1,39 @@
+#include "main.h"
+
+/**
+ * The implementation of the Pipeline namespace
+ * This file contains the source code for the Pipeline functions, along with
+ * explanations of how each function works
+ */
+
+MotorOutputs Pipeline::plan(const Tasks::SensorFrame & frame, TipGuard & guard) {
+    PROFILE_SCOPE("Pipeline::plan");
+    MotorOutputs out = {};
+    drive.plan(frame.controller, out);
+    guard.shape(frame, out);
+    //The driver controls are ignored while the color sorter is throwing out a ball
+    if(frame.indexer != IndexerState::ejecting) {
+        intake.plan(frame.controller, out);
+        conveyor.plan(frame.controller, out);
+    }
+    return out;
+}
+
+MotorOutputs Pipeline::plan(const Tasks::SensorFrame & frame) {
+    return plan(frame, tipGuard);
+}
+
+void Pipeline::flush(const MotorOutputs & out) {
+    PROFILE_SCOPE("Pipeline::flush");
+    if(out.driveSet) drive.setPower(out.driveLeft, out.driveRight);
+    if(out.intakeSet) intake.setPower(out.intake);
+    if(out.conveyorSet) conveyor.setPower(out.conveyor);
+}
+
+void Pipeline::tick(const Tasks::SensorFrame & frame, TipGuard & guard) {
+    flush(plan(frame, guard));
+}
+
+void Pipeline::tick(const Tasks::SensorFrame & frame) {
+    tick(frame, tipGuard);
+}
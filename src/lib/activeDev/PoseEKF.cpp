@@ -0,0 +1,131 @@
+#include "main.h"
+#include <cmath>
+
+/**
+ * The implementation of the PoseEKF class
+ * This file contains the source code for the PoseEKF class, along with
+ * explanations of how each function works
+ */
+
+PoseEKF::PoseEKF(TankDrive & d) : drive(d), published({{0, 0, 0}, 0, 0}), resetRequested(false), rejected(0) {
+    lastTime = 0;
+    resetPose = {0, 0, 0};
+    setState(resetPose);
+}
+
+void PoseEKF::setState(Pose pose) {
+    x = Matrix<states, 1>::zero();
+    x(X, 0) = pose.x;
+    x(Y, 0) = pose.y;
+    x(THETA, 0) = pose.theta * M_PI / 180;
+    P = Matrix<states, states>::zero();
+}
+
+void PoseEKF::predict(double dt, double accel) {
+    /**
+     * The robot moves along its heading at its speed (x uses sin and y uses
+     * cos, as the heading is a compass heading, the same as Odometry), turns at
+     * its turn rate, and speeds up by the IMU's acceleration. The turn rate is
+     * expected to stay the same
+     */
+    double theta = x(THETA, 0), v = x(VEL, 0);
+    double s = sin(theta), c = cos(theta);
+    x(X, 0) += v * dt * s;
+    x(Y, 0) += v * dt * c;
+    x(THETA, 0) += x(OMEGA, 0) * dt;
+    x(VEL, 0) += accel * dt;
+
+    /**
+     * F is the Jacobian of the step above: how much each new value changes with
+     * each old one. The covariance is carried through it, then grows by the
+     * process noise for the time that has passed
+     */
+    Matrix<states, states> F = Matrix<states, states>::identity();
+    F(X, THETA) = v * dt * c;
+    F(X, VEL) = dt * s;
+    F(Y, THETA) = -v * dt * s;
+    F(Y, VEL) = dt * c;
+    F(THETA, OMEGA) = dt;
+    P = F * P * F.transpose();
+    P(X, X) += positionNoise * dt;
+    P(Y, Y) += positionNoise * dt;
+    P(THETA, THETA) += headingNoise * dt;
+    P(VEL, VEL) += velocityNoise * dt;
+    P(OMEGA, OMEGA) += turnRateNoise * dt;
+}
+
+void PoseEKF::measure(int i, double z, double variance) {
+    /**
+     * Every reading is of one value in the state, so H is a row of zeroes with
+     * a 1 at i, and the usual matrix equations come down to:
+     * S = P(i, i) + variance, the variance of the innovation z - x(i)
+     * K = column i of P / S, how far to move each value towards the reading
+     * x += K * innovation, and P -= K * row i of P
+     * Updating with one reading at a time only ever divides by S, so no
+     * matrix has to be inverted
+     */
+    double innovation = z - x(i, 0);
+    double S = P(i, i) + variance;
+    if(innovation * innovation > gate * gate * S) {
+        rejected++;
+        return;
+    }
+    Matrix<states, 1> K;
+    for(int r = 0; r < states; r++) K(r, 0) = P(r, i) / S;
+    Matrix<1, states> row;
+    for(int c = 0; c < states; c++) row(0, c) = P(i, c);
+    x = x + K * innovation;
+    P = P - K * row;
+}
+
+void PoseEKF::update(const Tasks::SensorFrame & frame) {
+    PROFILE_SCOPE("PoseEKF::update");
+    if(resetRequested) {
+        setState(resetPose);
+        resetRequested = false;
+    }
+    if(lastTime == 0) {
+        lastTime = frame.time;
+        return;
+    }
+    double dt = (frame.time - lastTime) / 1e6;
+    lastTime = frame.time;
+    if(dt <= 0) return;
+    if(dt > maxStep) dt = maxStep;
+
+    //Without the IMU, the speed is predicted to stay the same and only the encoders correct it
+    double accel = frame.forwardAccel == PROS_ERR_F ? 0 : frame.forwardAccel * Inertial::gravity;
+    predict(dt, accel);
+
+    /**
+     * The side velocities are motor rpm, so they are turned into inches per
+     * second the same way the positions are. The speed is their average and the
+     * turn rate is their difference over the width of the base, the same as
+     * Odometry::update
+     */
+    double leftIn = drive.degreesToInches(frame.leftVel * 6);
+    double rightIn = drive.degreesToInches(frame.rightVel * 6);
+    measure(VEL, (leftIn + rightIn) / 2, encoderVelocityNoise);
+    measure(OMEGA, (leftIn - rightIn) / drive.getBaseWidth(), encoderTurnRateNoise);
+    if(frame.yawRate != PROS_ERR_F) measure(OMEGA, frame.yawRate * M_PI / 180, gyroTurnRateNoise);
+
+    published.write({{x(X, 0), x(Y, 0), x(THETA, 0) * 180 / M_PI}, x(VEL, 0), x(OMEGA, 0) * 180 / M_PI});
+}
+
+void PoseEKF::reset(Pose start) {
+    //The same hand over to the odometry task as Odometry::reset
+    resetPose = start;
+    resetRequested = true;
+}
+
+PoseEKF::Estimate PoseEKF::getEstimate() {
+    return published.read();
+}
+
+Pose PoseEKF::getPose() {
+    return published.read().pose;
+}
+
+uint32_t PoseEKF::getRejected() {
+    return rejected;
+}
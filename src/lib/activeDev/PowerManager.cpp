@@ -0,0 +1,184 @@
+#include "main.h"
+
+/**
+ * The implementation of the PowerManager class
+ * This file contains the source code for the PowerManager class, along with
+ * explanations of how each function works
+ */
+
+PowerManager::PowerManager(int totalBudget, double startTemp, double endTemp) {
+    budget = totalBudget;
+    derateStartTemp = startTemp;
+    derateEndTemp = endTemp;
+    overTempEvents = 0;
+    overCurrentEvents = 0;
+    throttleEvents = 0;
+    task = NULL;
+    period = 20;
+}
+
+void PowerManager::addGroup(const std::vector<int> & ports, PowerPriority priority) {
+    groups.push_back({ports, priority});
+    for(int p : ports) {
+        statuses.push_back({p, 0, 0, false, false, maxMotorCurrent});
+        throttled.push_back(false);
+    }
+    //Groups are only added before start(), so there is still only one writer
+    publish();
+}
+
+void PowerManager::publish() {
+    //Motors past maxMotors can't be on the robot, so they are left out
+    StatusList list;
+    list.count = std::min(statuses.size(), (size_t)maxMotors);
+    for(int i = 0; i < list.count; i++) {
+        list.motors[i] = statuses[i];
+    }
+    published.write(list);
+}
+
+double PowerManager::thermalFactor(const MotorStatus & s) {
+    /**
+     * The factor falls off linearly from 1 at derateStartTemp to
+     * minThermalFactor at derateEndTemp. The firmware's own cutoff starts
+     * at 55 degrees, so by the time a motor gets there it is already running
+     * at a reduced current and heating up much more slowly.
+     * If the motor reports its over temperature flag anyway, it gets the
+     * minimum straight away.
+     */
+    if(s.overTemp) return minThermalFactor;
+    if(s.temp <= derateStartTemp) return 1.0;
+    if(s.temp >= derateEndTemp) return minThermalFactor;
+    double t = (s.temp - derateStartTemp) / (derateEndTemp - derateStartTemp);
+    return 1.0 - t * (1.0 - minThermalFactor);
+}
+
+bool PowerManager::isActive(const MotorGroup & g) {
+    //A group counts as moving if any of its motors has more than half a volt applied
+    for(int p : g.ports) {
+        int32_t volt = pros::c::motor_get_voltage(p);
+        if(volt != PROS_ERR && abs(volt) > 500) return true;
+    }
+    return false;
+}
+
+void PowerManager::update() {
+    /**
+     * First, every motor is read once, and its thermal cap (the most current
+     * it may have at its current temperature) is worked out. Every motor is
+     * given floorCurrent (or its cap, if that is lower) off the top of the budget.
+     */
+    std::vector<int> caps(statuses.size());
+    std::vector<int> limits(statuses.size());
+    int remaining = budget;
+    for(size_t i = 0; i < statuses.size(); i++) {
+        MotorStatus & s = statuses[i];
+        double temp = pros::c::motor_get_temperature(s.port);
+        int32_t current = pros::c::motor_get_current_draw(s.port);
+        //Keep the last good reading if the motor is unplugged or errors out
+        if(temp != PROS_ERR_F) s.temp = temp;
+        if(current != PROS_ERR) s.current = current;
+        s.overTemp = pros::c::motor_is_over_temp(s.port) == 1;
+        s.overCurrent = pros::c::motor_is_over_current(s.port) == 1;
+        if(s.overTemp) overTempEvents++;
+        if(s.overCurrent) overCurrentEvents++;
+
+        caps[i] = maxMotorCurrent * thermalFactor(s);
+        limits[i] = std::min(caps[i], floorCurrent);
+        remaining -= limits[i];
+    }
+    /**
+     * The rest of the budget is handed out in passes. Moving high priority
+     * groups are served first, then moving low priority groups, then groups
+     * that are not moving at all. If a pass asks for more than is left, every
+     * motor in the pass gets the same fraction of what it asked for.
+     */
+    std::vector<bool> active;
+    for(const MotorGroup & g : groups) {
+        active.push_back(isActive(g));
+    }
+    for(int pass = 0; pass < 4; pass++) {
+        bool wantActive = pass < 2;
+        PowerPriority wantPriority = (pass % 2 == 0) ? PowerPriority::high : PowerPriority::low;
+        //Find the ports in this pass and how much current they still want
+        std::vector<int> indices;
+        int want = 0;
+        int index = 0;
+        for(size_t j = 0; j < groups.size(); j++) {
+            bool match = groups[j].priority == wantPriority && active[j] == wantActive;
+            for(size_t k = 0; k < groups[j].ports.size(); k++) {
+                if(match) {
+                    indices.push_back(index);
+                    want += caps[index] - limits[index];
+                }
+                index++;
+            }
+        }
+        if(want <= 0) continue;
+        double fraction = remaining >= want ? 1.0 : std::max(remaining, 0) / (double)want;
+        for(int i : indices) {
+            int extra = (caps[i] - limits[i]) * fraction;
+            limits[i] += extra;
+            remaining -= extra;
+        }
+    }
+    /**
+     * Finally, the new limits are written to the motors. A limit is only
+     * written if it has changed by more than limitHysteresis, since every write
+     * is a packet over the smart port link. A throttle event is counted when a
+     * motor's limit first drops below the current it is drawing, rather than on
+     * every update it stays there, as most motors are given less than
+     * maxMotorCurrent all the time without being held back by it.
+     */
+    for(size_t i = 0; i < statuses.size(); i++) {
+        MotorStatus & s = statuses[i];
+        bool nowThrottled = limits[i] < s.current;
+        if(nowThrottled && !throttled[i]) throttleEvents++;
+        throttled[i] = nowThrottled;
+        if(abs(limits[i] - s.currentLimit) > limitHysteresis ||
+           (limits[i] == maxMotorCurrent && s.currentLimit != maxMotorCurrent)) {
+            pros::c::motor_set_current_limit(s.port, limits[i]);
+            s.currentLimit = limits[i];
+        }
+    }
+    publish();
+}
+
+void PowerManager::taskFn(void * param) {
+    PowerManager * pm = static_cast<PowerManager *>(param);
+    int monitorId = TaskMonitor::add(Tasks::power.name, Tasks::power.stackDepth);
+    uint32_t now = pros::c::millis();
+    while(true) {
+        TaskMonitor::beginWork(monitorId);
+        pm->update();
+        TaskMonitor::endWork(monitorId);
+        pros::c::task_delay_until(&now, pm->period);
+    }
+}
+
+void PowerManager::start(uint32_t updatePeriod) {
+    //Only one background task is ever started, calling start() again just changes the period
+    period = updatePeriod;
+    if(task == NULL) {
+        task = pros::c::task_create(taskFn, this, Tasks::power.priority,
+                                    Tasks::power.stackDepth, Tasks::power.name);
+    }
+}
+
+std::vector<PowerManager::MotorStatus> PowerManager::getStatuses() {
+    //Read from the published copy, as the background task may be writing statuses
+    StatusList list = published.read();
+    return std::vector<MotorStatus>(list.motors, list.motors + list.count);
+}
+
+int PowerManager::getOverTempEvents() {
+    return overTempEvents;
+}
+
+int PowerManager::getOverCurrentEvents() {
+    return overCurrentEvents;
+}
+
+int PowerManager::getThrottleEvents() {
+    return throttleEvents;
+}
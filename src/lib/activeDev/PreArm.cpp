@@ -0,0 +1,116 @@
+#include "main.h"
+#include <atomic>
+
+/**
+ * The implementation of the PreArm namespace
+ * This file contains the source code for the PreArm functions, along with
+ * explanations of how each function works
+ */
+
+static Command * armedRoutine = NULL;
+static uint32_t armedGeneration = 0;
+/**
+ * armed is set only once everything else is ready, and arming is set while
+ * arm() runs and holds the AutonAnalyzer's lock, so recover() can tell if
+ * PROS ended the disabled task part of the way through
+ */
+static std::atomic<bool> armed(false);
+static std::atomic<bool> arming(false);
+static std::atomic<bool> matchStarted(false);
+static PreArm::Stats stats = {Auton::none, 0, 0, false, 0};
+
+void PreArm::run() {
+    /**
+     * The selection is checked every 50 ms, as it can be changed on the GUI
+     * while the robot is disabled. Arming only takes a few milliseconds, so it
+     * is long done by the time the robot is enabled
+     */
+    while(true) {
+        if(!armed || stats.id != autonID) arm();
+        pros::delay(50);
+    }
+}
+
+void PreArm::arm() {
+    imu.calibrate();
+    if(matchStarted) return;
+    /**
+     * If the GUI is analyzing or running a routine, it has the CommandPool,
+     * so arming is left for run() to try again next time
+     */
+    if(!AutonAnalyzer::tryLock()) return;
+    uint32_t start = pros::c::micros();
+    arming = true;
+    armed = false;
+    Auton id = autonID;
+    stats.id = id;
+    odom.reset();
+    ekf.reset();
+    localizer.reset();
+    if(id == Auton::replay) {
+        recorder.preload();
+        armedRoutine = NULL;
+        stats.expectedMs = recorder.getFrameCount() * recorder.getPeriod();
+    }
+    else {
+        /**
+         * The simulation resets the CommandPool, so the real routine is built
+         * after it. The pool's generation is kept so take() can tell if anything
+         * else (like AutonAnalyzer from the GUI) has reset the pool since
+         */
+        stats.expectedMs = AutonAnalyzer::simulate(id);
+        CommandPool::reset();
+        armedRoutine = buildRoutine(id);
+        armedGeneration = CommandPool::getGeneration();
+    }
+    stats.armUs = pros::c::micros() - start;
+    arming = false;
+    armed = true;
+    AutonAnalyzer::unlock();
+}
+
+bool PreArm::isArming() {
+    return arming;
+}
+
+void PreArm::recover() {
+    /**
+     * If PROS ended arm() partway through, the lock is still held, and if it
+     * was partway through a simulation, the Timeline is still simulating, so
+     * the real routine wouldn't move anything. The routine was only partly
+     * built, so it isn't armed
+     */
+    if(arming) {
+        Timeline::setSimulating(false);
+        armed = false;
+        arming = false;
+        AutonAnalyzer::unlock();
+    }
+}
+
+Command * PreArm::take(Auton id) {
+    //Once a competition autonomous starts, nothing is armed again until the program restarts
+    if(pros::c::competition_get_status() & COMPETITION_CONNECTED) matchStarted = true;
+    bool wasArmed = armed && stats.id == id;
+    bool usable = wasArmed && armedRoutine != NULL && armedGeneration == CommandPool::getGeneration();
+    armed = false;
+    //A replay has no routine to hand over, only the recording preload() loaded
+    stats.usedArmed = id == Auton::replay ? wasArmed : usable;
+    stats.id = id;
+    stats.timeToMotionUs = 0;
+    return usable ? armedRoutine : NULL;
+}
+
+void PreArm::recordFirstMotion(uint32_t us) {
+    stats.timeToMotionUs = us;
+}
+
+PreArm::Stats PreArm::getStats() {
+    return stats;
+}
+
+void PreArm::print() {
+    printf("\n[prearm] %s: armed in %u us (expected %u ms), %s, first motion %u us after start\n",
+           AutonAnalyzer::getName(stats.id), (unsigned)stats.armUs, (unsigned)stats.expectedMs,
+           stats.usedArmed ? "used armed routine" : "built at start", (unsigned)stats.timeToMotionUs);
+}
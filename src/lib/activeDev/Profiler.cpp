@@ -0,0 +1,85 @@
+#include "main.h"
+
+/**
+ * The implementation of the Profiler namespace
+ * This file contains the source code for the Profiler functions, along with
+ * explanations of how each function works
+ */
+
+//The first probe in the list of every probe. New probes are added to the front
+static std::atomic<Profiler::Probe *> head(NULL);
+
+Profiler::Probe::Probe(const char * probeName) : name(probeName), next(NULL) {
+    reset();
+    /**
+     * Probes are created the first time their block runs, which can happen in
+     * any task at any time, so the probe is added to the list with a
+     * compare-and-swap instead of a mutex. If another probe was added in
+     * between, next is updated and it tries again
+     */
+    Probe * oldHead = head.load();
+    do {
+        next = oldHead;
+    } while(!head.compare_exchange_weak(oldHead, this));
+}
+
+void Profiler::Probe::record(uint32_t us) {
+    count++;
+    totalUs += us;
+    //The minimum and maximum are only replaced if no other task has beaten this one to it
+    uint32_t oldMin = minUs.load();
+    while(us < oldMin && !minUs.compare_exchange_weak(oldMin, us)) {}
+    uint32_t oldMax = maxUs.load();
+    while(us > oldMax && !maxUs.compare_exchange_weak(oldMax, us)) {}
+    //The bucket is the number of bits in the time, so each bucket is twice as wide as the last
+    int bucket = us == 0 ? 0 : 32 - __builtin_clz(us);
+    if(bucket >= buckets) bucket = buckets - 1;
+    histogram[bucket]++;
+}
+
+void Profiler::Probe::reset() {
+    count = 0;
+    totalUs = 0;
+    minUs = UINT32_MAX;
+    maxUs = 0;
+    for(int i = 0; i < buckets; i++) {
+        histogram[i] = 0;
+    }
+}
+
+bool Profiler::isEnabled() {
+#ifdef ENABLE_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+Profiler::Probe * Profiler::first() {
+    return head.load();
+}
+
+void Profiler::print() {
+    if(!isEnabled()) {
+        printf("\n[profile] probes not compiled in, build with make PROFILE=1\n");
+        return;
+    }
+    printf("\n[profile] %-28s %8s %8s %10s %8s  histogram (<1us, <2us, <4us ... >=%dus)",
+           "probe", "count", "min us", "mean us", "max us", 1 << (buckets - 2));
+    for(Probe * p = first(); p != NULL; p = p->next) {
+        uint32_t count = p->count;
+        if(count == 0) continue;
+        printf("\n[profile] %-28s %8u %8u %10.2f %8u ", p->name, (unsigned)count,
+               (unsigned)p->minUs.load(), (double)p->totalUs.load() / count, (unsigned)p->maxUs.load());
+        for(int i = 0; i < buckets; i++) {
+            printf(" %u", (unsigned)p->histogram[i].load());
+        }
+    }
+    printf("\n");
+}
+
+void Profiler::reset() {
+    for(Probe * p = first(); p != NULL; p = p->next) {
+        p->reset();
+    }
+}
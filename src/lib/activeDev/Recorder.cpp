@@ -0,0 +1,169 @@
+#include "main.h"
+
+/**
+ * The implementation of the Recorder class
+ * This file contains the source code for the Recorder class, along with
+ * explanations of how each function works
+ */
+
+Recorder::Recorder(const char * file, uint32_t tickPeriod) {
+    path = file;
+    period = tickPeriod;
+    frameCount = 0;
+    framesToRecord = 0;
+    stopRequested = false;
+    preloaded = false;
+    savePending = false;
+    saving = false;
+}
+
+void Recorder::arm(uint32_t duration) {
+    /**
+     * savePending is cleared before saving is checked, and flush() sets saving
+     * before it checks savePending, so either flush() sees there is nothing to
+     * save, or this waits for it to finish writing the old frames
+     */
+    savePending = false;
+    while(saving) pros::delay(5);
+    preloaded = false;
+    frameCount = 0;
+    framesToRecord = std::min<int>(duration / period, maxFrames);
+}
+
+void Recorder::disarm() {
+    if(framesToRecord == 0) return;
+    framesToRecord = 0;
+    savePending = true;
+}
+
+bool Recorder::isArmed() {
+    return framesToRecord > 0;
+}
+
+void Recorder::record(const ControllerState & input) {
+    /**
+     * Recording only copies the frame into the array. Once the last frame is
+     * in, the recording is marked for flush() to write from a low priority
+     * task, so the driver control loop never waits on the microSD card
+     */
+    if(framesToRecord == 0) return;
+    frames[frameCount++] = input;
+    if(frameCount >= framesToRecord) {
+        framesToRecord = 0;
+        savePending = true;
+    }
+}
+
+void Recorder::flush() {
+    saving = true;
+    if(savePending.exchange(false)) save();
+    saving = false;
+}
+
+bool Recorder::save() {
+    if(!pros::c::usd_is_installed()) return false;
+    FILE * f = fopen(path, "wb");
+    if(f == NULL) return false;
+    /**
+     * The header and frames are written byte by byte in a fixed order, rather than
+     * writing the structs directly, so the file doesn't depend on struct padding and
+     * can be read by tools on a computer
+     */
+    uint8_t header[12] = {'R', 'P', 'L', '1'};
+    for(int i = 0; i < 4; i++) {
+        header[4 + i] = (period >> (8 * i)) & 0xFF;
+        header[8 + i] = (frameCount >> (8 * i)) & 0xFF;
+    }
+    fwrite(header, 1, sizeof(header), f);
+    for(int i = 0; i < frameCount; i++) {
+        uint8_t frame[6];
+        for(int a = 0; a < 4; a++) {
+            frame[a] = frames[i].analog[a];
+        }
+        frame[4] = frames[i].digital & 0xFF;
+        frame[5] = frames[i].digital >> 8;
+        fwrite(frame, 1, sizeof(frame), f);
+    }
+    fclose(f);
+    printf("\nRecorder: saved %d frames to %s", frameCount, path);
+    return true;
+}
+
+bool Recorder::load() {
+    frameCount = 0;
+    if(!pros::c::usd_is_installed()) return false;
+    FILE * f = fopen(path, "rb");
+    if(f == NULL) return false;
+    uint8_t header[12];
+    if(fread(header, 1, sizeof(header), f) != sizeof(header) ||
+       header[0] != 'R' || header[1] != 'P' || header[2] != 'L' || header[3] != '1') {
+        fclose(f);
+        return false;
+    }
+    uint32_t filePeriod = 0;
+    uint32_t count = 0;
+    for(int i = 0; i < 4; i++) {
+        filePeriod |= header[4 + i] << (8 * i);
+        count |= header[8 + i] << (8 * i);
+    }
+    //A recording made at a different tick period wouldn't replay at the same timing
+    if(filePeriod != period) {
+        fclose(f);
+        return false;
+    }
+    uint8_t frame[6];
+    while(frameCount < count && frameCount < maxFrames && fread(frame, 1, sizeof(frame), f) == sizeof(frame)) {
+        for(int a = 0; a < 4; a++) {
+            frames[frameCount].analog[a] = frame[a];
+        }
+        frames[frameCount].digital = frame[4] | (frame[5] << 8);
+        frameCount++;
+    }
+    fclose(f);
+    return true;
+}
+
+bool Recorder::replay(void (*tick)(const ControllerState &)) {
+    /**
+     * The file is loaded completely before the first frame is played, then each
+     * frame is passed to tick at exactly the recorded period. task_delay_until
+     * is used rather than pros::delay so the time tick takes doesn't add up
+     * over the recording. A recording loaded by preload() is used as it is
+     */
+    //A stop asked for before the replay started was meant for an earlier one
+    stopRequested = false;
+    bool ready = preloaded.exchange(false) || load();
+    if(!ready) {
+        printf("\nRecorder: no recording found at %s", path);
+        stopRequested = false;
+        return false;
+    }
+    uint32_t now = pros::c::millis();
+    for(int i = 0; i < frameCount && !stopRequested; i++) {
+        tick(frames[i]);
+        pros::c::task_delay_until(&now, period);
+    }
+    //Stopping everything with an empty frame once the recording is over
+    ControllerState idle = {{0, 0, 0, 0}, 0};
+    tick(idle);
+    stopRequested = false;
+    return true;
+}
+
+bool Recorder::preload() {
+    preloaded = false;
+    preloaded = load();
+    return preloaded;
+}
+
+void Recorder::stopReplay() {
+    stopRequested = true;
+}
+
+uint32_t Recorder::getPeriod() {
+    return period;
+}
+
+int Recorder::getFrameCount() {
+    return frameCount;
+}
@@ -0,0 +1,254 @@
+#include "main.h"
+#include <cmath>
+
+/**
+ * The implementation of the robot's commands
+ * This file contains the source code for the commands in RobotCommands.hpp, along
+ * with explanations of how each function works
+ */
+
+DriveCommand::DriveCommand(TankDrive & d, bool isTurn, double amt, uint32_t settleTime, MoveMode moveMode)
+    : Command(Subsystem::drive), drive(d) {
+    turn = isTurn;
+    amount = amt;
+    settle = settleTime;
+    mode = moveMode;
+    done = false;
+    doneTime = 0;
+    simEnd = 0;
+}
+
+void DriveCommand::initialize() {
+    done = false;
+    if(Timeline::isSimulating()) {
+        //Both sides travel the same distance in a turn, just in opposite directions
+        simEnd = Timeline::now() + Timeline::simMoveTime(turn ? drive.getTurnLength(amount) : amount);
+        Pose p = Timeline::getSimPose();
+        if(turn) p.theta += amount;
+        else {
+            p.x += amount * sin(p.theta * M_PI / 180);
+            p.y += amount * cos(p.theta * M_PI / 180);
+        }
+        Timeline::setSimPose(p);
+        return;
+    }
+    if(turn) drive.startTurn(amount, mode);
+    else drive.startStraight(amount, mode);
+}
+
+void DriveCommand::execute() {
+    /**
+     * updateMove is called once per scheduler tick, which runs at the same
+     * 20 ms period drivePID uses. Once the move is done, the motors are
+     * stopped and the command waits out the settle time
+     */
+    if(done) return;
+    if(Timeline::isSimulating()) {
+        if(Timeline::now() >= simEnd) {
+            done = true;
+            doneTime = Timeline::now();
+        }
+        return;
+    }
+    if(drive.updateMove()) {
+        drive.endMove();
+        done = true;
+        doneTime = Timeline::now();
+    }
+}
+
+bool DriveCommand::isFinished() {
+    return done && Timeline::now() - doneTime >= settle;
+}
+
+void DriveCommand::end(bool interrupted) {
+    if(!done && !Timeline::isSimulating()) drive.endMove();
+}
+
+MoveToCommand::MoveToCommand(TankDrive & d, Pose fieldTarget, bool heading, bool backwards,
+                             double exit, uint32_t settleTime)
+    : Command(Subsystem::drive), drive(d) {
+    target = fieldTarget;
+    useHeading = heading;
+    reverse = backwards;
+    exitRadius = exit;
+    settle = settleTime;
+    done = false;
+    doneTime = 0;
+    simEnd = 0;
+}
+
+void MoveToCommand::initialize() {
+    /**
+     * The target is on the field, and the odometry's pose is from where the
+     * robot started, so the target is moved into the odometry's frame once,
+     * here. The Localizer keeps the odometry lined up with the field
+     */
+    done = false;
+    Pose goal = localizer.toOdom(target);
+    if(Timeline::isSimulating()) {
+        /**
+         * The curve is a little longer than the straight line, but the
+         * straight line is close enough to estimate the time. A chained move
+         * hands over before the end, still moving, so it is cut short by its
+         * exit radius
+         */
+        Pose p = Timeline::getSimPose();
+        double distance = sqrt((goal.x - p.x) * (goal.x - p.x) + (goal.y - p.y) * (goal.y - p.y));
+        simEnd = Timeline::now() + Timeline::simMoveTime(std::max(0.0, distance - exitRadius));
+        if(!useHeading) goal.theta = atan2(goal.x - p.x, goal.y - p.y) * 180 / M_PI + (reverse ? 180 : 0);
+        Timeline::setSimPose(goal);
+        return;
+    }
+    drive.startMoveTo(goal, useHeading, reverse, 0.6, exitRadius);
+}
+
+void MoveToCommand::execute() {
+    //The same as DriveCommand, except a chained move leaves the motors running for the next move
+    if(done) return;
+    if(Timeline::isSimulating()) {
+        if(Timeline::now() >= simEnd) {
+            done = true;
+            doneTime = Timeline::now();
+        }
+        return;
+    }
+    if(drive.updateMoveTo(odom.getPose())) {
+        if(exitRadius <= 0) drive.endMove();
+        done = true;
+        doneTime = Timeline::now();
+    }
+}
+
+bool MoveToCommand::isFinished() {
+    return done && Timeline::now() - doneTime >= settle;
+}
+
+void MoveToCommand::end(bool interrupted) {
+    /**
+     * A chained move that finished leaves the motors running only if the next
+     * command in its sequence drives, as that one takes them over in the same
+     * tick. Otherwise (the end of a sequence, a wait or anything else next, or
+     * an interrupted move) the drive is stopped, so it isn't left running with
+     * nothing driving it
+     */
+    if(Timeline::isSimulating()) return;
+    bool handedOver = done && exitRadius > 0 && next != NULL && (next->getRequirements() & Subsystem::drive);
+    if(!handedOver) drive.endMove();
+}
+
+IntakeCommand::IntakeCommand(Intake & in, int dir, bool holdUntilInterrupted)
+    : Command(Subsystem::intake), intake(in) {
+    direction = dir;
+    hold = holdUntilInterrupted;
+}
+
+void IntakeCommand::initialize() {
+    if(Timeline::isSimulating()) return;
+    if(direction > 0) intake.in();
+    else if(direction < 0) intake.out();
+    else intake.stop();
+}
+
+bool IntakeCommand::isFinished() {
+    return !hold;
+}
+
+void IntakeCommand::end(bool interrupted) {
+    if(hold && !Timeline::isSimulating()) intake.stop();
+}
+
+ConveyorCommand::ConveyorCommand(Conveyor & conv, int dir, bool holdUntilInterrupted)
+    : Command(Subsystem::conveyor), conveyor(conv) {
+    direction = dir;
+    hold = holdUntilInterrupted;
+}
+
+void ConveyorCommand::initialize() {
+    if(Timeline::isSimulating()) return;
+    if(direction > 0) conveyor.moveUp();
+    else if(direction < 0) conveyor.moveDown();
+    else conveyor.stop();
+}
+
+bool ConveyorCommand::isFinished() {
+    return !hold;
+}
+
+void ConveyorCommand::end(bool interrupted) {
+    if(hold && !Timeline::isSimulating()) conveyor.stop();
+}
+
+IndexerIntakeCommand::IndexerIntakeCommand(Indexer & idx)
+    : Command(Subsystem::intake | Subsystem::conveyor), indexer(idx) {}
+
+void IndexerIntakeCommand::initialize() {
+    if(Timeline::isSimulating()) return;
+    indexer.intakeBalls();
+}
+
+IndexerScoreCommand::IndexerScoreCommand(Indexer & idx, int numBalls, uint32_t ms)
+    : Command(Subsystem::intake | Subsystem::conveyor), indexer(idx) {
+    balls = numBalls;
+    timeout = ms;
+    simEnd = 0;
+}
+
+void IndexerScoreCommand::initialize() {
+    if(Timeline::isSimulating()) {
+        simEnd = Timeline::now() + std::min(balls * Timeline::simScoreTime, timeout);
+        return;
+    }
+    indexer.shoot(balls, timeout);
+}
+
+bool IndexerScoreCommand::isFinished() {
+    if(Timeline::isSimulating()) return Timeline::now() >= simEnd;
+    return !indexer.isShooting();
+}
+
+void IndexerScoreCommand::end(bool interrupted) {
+    //If the command is cut short, the balls left are held where they are
+    if(interrupted && !Timeline::isSimulating()) indexer.hold();
+}
+
+Command * Commands::straight(TankDrive & drive, double distance, MoveMode mode) {
+    return makeCommand<DriveCommand>(drive, false, distance, 200, mode);
+}
+
+Command * Commands::turn(TankDrive & drive, double angle, MoveMode mode) {
+    return makeCommand<DriveCommand>(drive, true, angle, 200, mode);
+}
+
+Command * Commands::moveToPoint(TankDrive & drive, double x, double y, bool reverse, double exitRadius) {
+    //A chained move doesn't wait to settle, as the robot is still moving when it hands over
+    return makeCommand<MoveToCommand>(drive, Pose{x, y, 0}, false, reverse, exitRadius, exitRadius > 0 ? 0 : 200);
+}
+
+Command * Commands::moveToPose(TankDrive & drive, double x, double y, double theta, bool reverse, double exitRadius) {
+    return makeCommand<MoveToCommand>(drive, Pose{x, y, theta}, true, reverse, exitRadius, exitRadius > 0 ? 0 : 200);
+}
+
+Command * Commands::setIntake(Intake & intake, int direction) {
+    return makeCommand<IntakeCommand>(intake, direction, false);
+}
+
+Command * Commands::runIntake(Intake & intake, int direction) {
+    return makeCommand<IntakeCommand>(intake, direction, true);
+}
+
+Command * Commands::setConveyor(Conveyor & conveyor, int direction) {
+    return makeCommand<ConveyorCommand>(conveyor, direction, false);
+}
+
+Command * Commands::runConveyor(Conveyor & conveyor, int direction) {
+    return makeCommand<ConveyorCommand>(conveyor, direction, true);
+}
+
+Command * Commands::indexerIntake(Indexer & indexer) {
+    return makeCommand<IndexerIntakeCommand>(indexer);
+}
+
+Command * Commands::score(Indexer & indexer, int balls, uint32_t timeout) {
+    return makeCommand<IndexerScoreCommand>(indexer, balls, timeout);
+}
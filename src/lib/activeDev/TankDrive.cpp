@@ -1,4 +1,5 @@
 #include "main.h"
+#include <cmath>
 
 /**
  * The implementation of the TankDrive class
@@ -9,7 +10,14 @@
 TankDrive::TankDrive(std::initializer_list<int> leftPorts, std::initializer_list<int> rightPorts, 
                   std::initializer_list<bool> leftRevs, std::initializer_list<bool> rightRevs,
                   pros::motor_gearset_e_t gearset, double wD, double bW,
-                  double Pconst, double Iconst, double Dconst) {
+                  double Pconst, double Iconst, double Dconst)
+    /**
+     * The integral is clamped so that on its own it can never ask for more than
+     * the motors' full 12000 mV, and the derivative is low-pass filtered with
+     * half of each new sample
+     */ 
+    : leftPID(Pconst, Iconst, Dconst, Iconst > 0 ? 12000 / Iconst : 0, 12000, 0.5),
+      rightPID(Pconst, Iconst, Dconst, Iconst > 0 ? 12000 / Iconst : 0, 12000, 0.5) {
     leftMotorPorts = leftPorts;
     rightMotorPorts = rightPorts;
     std::vector<bool> leftMotorRevs = leftRevs;
@@ -23,34 +31,74 @@ TankDrive::TankDrive(std::initializer_list<int> leftPorts, std::initializer_list
         pros::c::motor_set_gearing(rightMotorPorts[i], gearset);
         pros::c::motor_set_reversed(rightMotorPorts[i], rightMotorRevs[i]);
     }
-    wheelDiameter = wD;
-    baseWidth = bW;
-    kP = Pconst;
-    kI = Iconst;
-    kD = Dconst;
+    setGeometry(wD, bW);
+    //The red, green and blue cartridges turn at 100, 200 and 600 rpm
+    if(gearset == pros::E_MOTOR_GEARSET_36) maxRpm = 100;
+    else if(gearset == pros::E_MOTOR_GEARSET_06) maxRpm = 600;
+    else maxRpm = 200;
+    moveMode = MoveMode::brain;
+    onboardPidSet = false;
+    lastTractionTime = 0;
+    leftFusion = {std::vector<double>(leftMotorPorts.size(), 0), std::vector<bool>(leftMotorPorts.size(), false), 0};
+    rightFusion = {std::vector<double>(rightMotorPorts.size(), 0), std::vector<bool>(rightMotorPorts.size(), false), 0};
+    rejectedReadings = 0;
 
     //updateLeftTelemetry();
     //updateRightTelemetry();
 }
 
 void TankDrive::driver(pros::controller_id_e_t controller) {
+    driver(ControllerState::read(controller));
+}
+
+void TankDrive::driver(const ControllerState & input) {
+    PROFILE_SCOPE("TankDrive::driver");
+    MotorOutputs out = {};
+    plan(input, out);
+    setPower(out.driveLeft, out.driveRight);
+}
+
+void TankDrive::plan(const ControllerState & input, MotorOutputs & out) const {
     /**
-     * The driver function uses the okapi controller object to get the values of
-     * the Y axes on each controller joystick. Then, each base motor group is set 
-     * to the value of its corresponding joystick. Since the getAnalog function
-     * returns a value between -1 and 1, the controllerSet function is used to 
-     * set the motors, as it accepts values in that range
+     * The plan function gets the values of the Y axes on each controller 
+     * joystick from the controller state. Then, each base motor group is set 
+     * to the value of its corresponding joystick. The joystick values range from
+     * -127 to 127, the same range motor_move accepts
      */ 
+    out.driveLeft = input.getAnalog(ANALOG_LEFT_Y);
+    out.driveRight = input.getAnalog(ANALOG_RIGHT_Y);
+    out.driveSet = true;
+}
+
+void TankDrive::setPower(int leftPower, int rightPower) {
     for(int p : leftMotorPorts) {
-        pros::c::motor_move(p, pros::c::controller_get_analog(controller, ANALOG_LEFT_Y));
+        pros::c::motor_move(p, leftPower);
     }
     for(int p : rightMotorPorts) {
-        pros::c::motor_move(p, pros::c::controller_get_analog(controller, ANALOG_RIGHT_Y));
+        pros::c::motor_move(p, rightPower);
     }
 }
 
-void TankDrive::drivePID(double leftT, double rightT)
+void TankDrive::drivePID(double leftT, double rightT, MoveMode mode)
 {
+    PROFILE_SCOPE("TankDrive::drivePID");
+    /**
+     * drivePID runs a whole move at once: it starts the move, updates it every
+     * 20 ms until it is done, then stops the motors and gives the robot 200 ms
+     * to come to rest. Commands (see RobotCommands.hpp) call startMove, updateMove
+     * and endMove themselves, so other subsystems can run during the move
+     */ 
+    startMove(leftT, rightT, mode);
+    while(!updateMove()) {
+        pros::delay(20);
+    }
+    endMove();
+    pros::delay(200);
+}
+
+void TankDrive::startMove(double leftT, double rightT, MoveMode mode)
+{
+    PROFILE_SCOPE("TankDrive::startMove");
     /**
      * Convert leftTarg and rightTarg from inches to travel to degrees for the
      * wheels to rotate
@@ -59,72 +107,423 @@ void TankDrive::drivePID(double leftT, double rightT)
      * travel 4*pi inches over 1 full rotation.
      * So, the conversion factor between inches to travel and degrees to rotate is
      * 360 degrees/(wheel diameter * pi), as wheel diameter times pi is the inches traveled
-     * over 1 rotation, while 360 degrees is degrees rotated over 1 rotation
+     * over 1 rotation, while 360 degrees is degrees rotated over 1 rotation. This is
+     * degreesPerInch, worked out in setGeometry
+     */ 
+    stuckCount = 0;
+    /**
+     * The targets are relative to where each side is now. The encoders used to be
+     * tared at the start of every move instead, but the odometry task reads the
+     * same encoders, and would see every tare as the robot jumping backwards
+     */
+    leftPos = getLeftPosition();
+    rightPos = getRightPosition();
+    leftTarg = leftPos + inchesToDegrees(leftT);
+    rightTarg = rightPos + inchesToDegrees(rightT);
+    //Clear the integral and derivative left over from the last move
+    leftPID.reset();
+    rightPID.reset();
+    //Initialize all variables used while the move runs
+    leftError = leftTarg - leftPos; 
+    rightError = rightTarg - rightPos;
+    voltCap = 0.0;
+    moveMode = mode;
+    traction.reset((degreesToInches(getLeftState().velocity * 6) + degreesToInches(getRightState().velocity * 6)) / 2);
+    lastTractionTime = 0;
+    if(mode == MoveMode::onboard) {
+        /**
+         * Each motor is sent the same distance relative to where it is, so the
+         * motors on a side don't need their encoders to agree. The speed limit
+         * starts at 0 and is raised by updateOnboardMove, the same way voltCap
+         * is for brain moves
+         */
+        leftDistance = leftError;
+        rightDistance = rightError;
+        speedCap = 0;
+        for(int p : leftMotorPorts) {
+            if(onboardPidSet) pros::c::motor_set_pos_pid(p, onboardPid);
+            pros::c::motor_move_relative(p, leftDistance, 0);
+        }
+        for(int p : rightMotorPorts) {
+            if(onboardPidSet) pros::c::motor_set_pos_pid(p, onboardPid);
+            pros::c::motor_move_relative(p, rightDistance, 0);
+        }
+    }
+}
+
+bool TankDrive::updateMove()
+{
+    PROFILE_SCOPE("TankDrive::updateMove");
+    if(moveMode == MoveMode::onboard) return updateOnboardMove();
+    //The move is done once both sides are within 5 degrees of target rotation
+    if(abs(leftError) <= 5 && abs(rightError) <= 5) return true;
+    /**
+     * The output is ramped up by 600 mV every loop, so the robot doesn't
+     * jerk forward at the start of a move. The PID controllers clamp their
+     * output to the current cap. While the wheels slip, the ramp is held
+     * where it is, so it doesn't climb past the output that broke them loose
      */ 
-    short int count = 0;
-    double leftTarg = leftT * 360/(wheelDiameter * 3.1415) * 2;
-    double rightTarg = rightT * 360/(wheelDiameter * 3.1415) * 2;
-    //Reset the encoders of the first motor on each side
-    pros::c::motor_tare_position(leftMotorPorts[0]);
-    pros::c::motor_tare_position(rightMotorPorts[0]);
-    //Declare or initialize all variables used in the loop
-    double leftError = leftTarg - pros::c::motor_get_position(leftMotorPorts[0]); 
-    double rightError = rightTarg - pros::c::motor_get_position(rightMotorPorts[0]);
-    double leftOutput;
-    double rightOutput;
-    double voltCap = 0.0;
-    //Integral variables are initiated so that the += operator can be used throughout the while loop
-    double leftIntegral = 0;
-    double rightIntegral = 0;
-    double leftDerivative;
-    double rightDerivative;
-    //Declaring the Previous Error Variable
-    double leftPrevError;
-    double rightPrevError;
-    //Enter a while loop that runs until both sides are within 10 degrees of target rotation
-    while(abs(leftError) > 5 || abs(rightError) > 5)
+    double grip = updateTraction();
+    if(!traction.isSlipping()) {
+        if(voltCap < 12000) voltCap += 600;
+        else voltCap = 12000;
+    }
+    leftPID.setOutputLimit(voltCap);
+    rightPID.setOutputLimit(voltCap);
+
+    //Set the output values. The PID math is timed on its own, apart from the motor I/O
+    double leftOutput, rightOutput;
+    {
+        PROFILE_SCOPE("TankDrive::updateMove PID math");
+        leftOutput = leftPID.update(leftTarg, leftPos);
+        rightOutput = rightPID.update(rightTarg, rightPos);
+    }
+    /**
+     * If the wheels are slipping, the output sent to the motors is cut back
+     * until they grip. Only what is sent is cut, not the ramp, so the cut
+     * doesn't compound from one update to the next
+     */
+    leftOutput *= grip;
+    rightOutput *= grip;
+
+    //Set the motor group voltages to the output velocity levels
+    setVoltage(leftOutput, rightOutput);
+    //Calculate the new error
+    double leftPrevError = leftError;
+    double rightPrevError = rightError;
     {
-        printf("\nLeft Targ: %f, Left Error: %f", leftTarg, leftError);
-        printf("\nRight Targ: %f, Right Error: %f", rightTarg, rightError);
-        //Calculate the integral
-        leftIntegral += leftError;
-        rightIntegral += rightError;
+        PROFILE_SCOPE("TankDrive::updateMove position read");
+        leftPos = getLeftPosition();
+        rightPos = getRightPosition();
+    }
+    leftError = leftTarg - leftPos; 
+    rightError = rightTarg - rightPos;
+    //If neither side has moved for 5 updates, the robot is stuck and the move ends
+    if(leftError == leftPrevError && rightError == rightPrevError) stuckCount++;
+    else stuckCount = 0;
+    return stuckCount >= 5 || (abs(leftError) <= 5 && abs(rightError) <= 5);
+}
 
-        //Calculate the derivative
-        leftDerivative = leftError - leftPrevError;
-        rightDerivative = rightError - rightPrevError;
+bool TankDrive::updateOnboardMove()
+{
+    PROFILE_SCOPE("TankDrive::updateOnboardMove");
+    /**
+     * Both sides share one speed limit, raised by a tenth of the top speed
+     * every update (full speed after 200 ms, like voltCap). Each side gets the
+     * share of it that matches its share of the distance, so a side with less
+     * to travel moves slower and both sides arrive together
+     */
+    //Slipping wheels are handled the same way as brain moves: the ramp is held, and only what is sent is cut
+    double grip = updateTraction();
+    if(!traction.isSlipping()) {
+        if(speedCap < maxRpm) speedCap += maxRpm / 10.0;
+        if(speedCap > maxRpm) speedCap = maxRpm;
+    }
+    double longest = std::max(std::abs(leftDistance), std::abs(rightDistance));
+    if(longest > 0) {
+        int leftSpeed = speedCap * grip * std::abs(leftDistance) / longest;
+        int rightSpeed = speedCap * grip * std::abs(rightDistance) / longest;
+        for(int p : leftMotorPorts) {
+            pros::c::motor_modify_profiled_velocity(p, leftSpeed);
+        }
+        for(int p : rightMotorPorts) {
+            pros::c::motor_modify_profiled_velocity(p, rightSpeed);
+        }
+    }
+    /**
+     * The motors decide for themselves how to finish the move, so the brain
+     * only watches the fused position of each side. The move is done once both
+     * are within 5 degrees of their targets and have nearly stopped, or
+     * neither has moved for 5 updates
+     */
+    double leftPrevError = leftError;
+    double rightPrevError = rightError;
+    leftPos = getLeftPosition();
+    rightPos = getRightPosition();
+    leftError = leftTarg - leftPos;
+    rightError = rightTarg - rightPos;
+    if(leftError == leftPrevError && rightError == rightPrevError) stuckCount++;
+    else stuckCount = 0;
+    bool stopped = std::abs(getLeftState().velocity) < 2 && std::abs(getRightState().velocity) < 2;
+    return stuckCount >= 5 || (std::abs(leftError) <= 5 && std::abs(rightError) <= 5 && stopped);
+}
 
-        //Set the previous error
-        leftPrevError = leftError;
-        rightPrevError = rightError;
+void TankDrive::setOnboardPid(double kf, double kp, double ki, double kd)
+{
+    onboardPid = pros::c::motor_convert_pid(kf, kp, ki, kd);
+    onboardPidSet = true;
+}
 
-        //Set the output values
-        leftOutput = (leftError * kP) + (leftIntegral * kI) + (leftDerivative * kD);
-        rightOutput = (rightError * kP) + (rightIntegral * kI) + (rightDerivative * kD);
+void TankDrive::endMove()
+{
+    PROFILE_SCOPE("TankDrive::endMove");
+    setVelocity(0, 0);
+}
 
-        if(voltCap < 12000) voltCap += 600;
-        else voltCap = 12000;
+void TankDrive::startMoveTo(Pose target, bool useHeading, bool reverse, double lead,
+                            double exitRadius, double maxVolt)
+{
+    PROFILE_SCOPE("TankDrive::startMoveTo");
+    poseTarget = target;
+    poseUseHeading = useHeading;
+    poseReverse = reverse;
+    poseLead = lead;
+    poseExitRadius = exitRadius;
+    poseMaxVolt = maxVolt;
+    //The forward output starts from the robot's current speed, so a chained move doesn't jerk
+    double speed = (getLeftState().velocity + getRightState().velocity) / 2;
+    poseLinear = fabs(speed) / maxRpm * 12000;
+    stuckCount = 0;
+    traction.reset(degreesToInches(speed * 6));
+    lastTractionTime = 0;
+}
 
-        if(abs(leftOutput) > voltCap) leftOutput = copysign(voltCap, leftOutput);
-        if(abs(rightOutput) > voltCap) rightOutput = copysign(voltCap, rightOutput);
-        printf("\nLeft Output: %f Right Output: %f", leftOutput, rightOutput);
-
-        //Set the motor group voltages to the output velocity levels
-        setVoltage(leftOutput, rightOutput);
-        //Calculate the new error
-        leftError = leftTarg - pros::c::motor_get_position(leftMotorPorts[0]); 
-        rightError = rightTarg - pros::c::motor_get_position(rightMotorPorts[0]);
-        if(leftError == leftPrevError && rightError == rightPrevError) count++;
-        else count = 0;
-        if(count >= 5) break;
-        pros::delay(20);
+bool TankDrive::updateMoveTo(Pose current)
+{
+    PROFILE_SCOPE("TankDrive::updateMoveTo");
+    /**
+     * The angles here are compass headings, like the Pose's: the direction
+     * from one point to another is atan2 of the x difference over the y
+     * difference, and sin goes with x and cos with y. When driving backwards,
+     * the direction the robot travels is its heading plus 180 degrees
+     */
+    double dx = poseTarget.x - current.x;
+    double dy = poseTarget.y - current.y;
+    double distance = sqrt(dx * dx + dy * dy);
+    double travel = current.theta + (poseReverse ? 180 : 0);
+    double headingError = wrap180(poseTarget.theta - current.theta);
+
+    /**
+     * The carrot is lead * distance behind the target along the way the robot
+     * should be travelling when it gets there. Steering at it curves the robot
+     * round to that heading, and as the distance shrinks the carrot slides
+     * onto the target itself
+     */
+    double carrotX = poseTarget.x, carrotY = poseTarget.y;
+    if(poseUseHeading) {
+        double arrive = (poseTarget.theta + (poseReverse ? 180 : 0)) * M_PI / 180;
+        carrotX -= poseLead * distance * sin(arrive);
+        carrotY -= poseLead * distance * cos(arrive);
     }
-    setVelocity(0, 0);
-    pros::delay(200);
+    bool settling = distance < poseSettleRadius;
+    double turnError;
+    if(settling) turnError = poseUseHeading ? headingError : 0;
+    else turnError = wrap180(atan2(carrotX - current.x, carrotY - current.y) * 180 / M_PI - travel);
+
+    /**
+     * The forward output is the distance to the target along the way the robot
+     * is travelling, so it slows down while the robot is pointed the wrong way,
+     * and backs up if the robot has gone past the target. Turning comes first:
+     * the forward output is cut so that the side turning faster stays under
+     * the limit
+     */
+    double along = distance * cos(wrap180(atan2(dx, dy) * 180 / M_PI - travel) * M_PI / 180);
+    double angular = std::max(-poseMaxVolt, std::min(poseMaxVolt, poseAngularGain * turnError));
+    double limit = poseMaxVolt - fabs(angular);
+    double linear = std::max(-limit, std::min(limit, poseLinearGain * along));
+    if(fabs(linear) > fabs(poseLinear) + poseSlew) linear = linear > 0 ? fabs(poseLinear) + poseSlew : -(fabs(poseLinear) + poseSlew);
+    /**
+     * Slipping cuts both outputs sent to the motors. The slew carries on from
+     * the output before the cut, and while slipping it may fall but not rise,
+     * so it neither compounds the cut nor climbs past where the wheels slipped
+     */
+    double grip = updateTraction();
+    if(!traction.isSlipping() || fabs(linear) < fabs(poseLinear)) poseLinear = linear;
+    linear *= grip;
+    angular *= grip;
+    if(poseReverse) linear = -linear;
+    setVoltage(linear + angular, linear - angular);
+
+    /**
+     * The robot is stuck if both sides have barely turned for a while, over
+     * the whole move, chained or not. Once settling, that means it has stopped
+     * at the target, so 100 ms is enough. Before then it may be pinned against
+     * something, but it may also be pulling away, so it gets poseStuckUpdates
+     */
+    double speed = fabs(getLeftState().velocity) + fabs(getRightState().velocity);
+    stuckCount = speed < 4 ? stuckCount + 1 : 0;
+    if(stuckCount >= (settling ? 5 : poseStuckUpdates)) return true;
+    if(poseExitRadius > 0) return distance < poseExitRadius;
+    if(poseUseHeading) return distance < poseExitDistance && fabs(headingError) < poseExitAngle;
+    return distance < poseExitDistance || (settling && along < 0);
+}
+
+void TankDrive::startStraight(double distance, MoveMode mode)
+{
+    PROFILE_SCOPE("TankDrive::startStraight");
+    startMove(distance, distance, mode);
+}
+
+void TankDrive::startTurn(double angle, MoveMode mode)
+{
+    PROFILE_SCOPE("TankDrive::startTurn");
+    double turnLength = getTurnLength(angle);
+    startMove(turnLength, -turnLength, mode);
+}
+
+double TankDrive::inchesToDegrees(double inches)
+{
+    return inches * degreesPerInch;
+}
+
+double TankDrive::degreesToInches(double degrees)
+{
+    return degrees / degreesPerInch;
+}
+
+double TankDrive::getBaseWidth()
+{
+    return baseWidth;
+}
+
+double TankDrive::getWheelDiameter()
+{
+    return wheelDiameter;
+}
+
+int TankDrive::getMaxRpm()
+{
+    return maxRpm;
+}
+
+void TankDrive::setGeometry(double wD, double bW)
+{
+    /**
+     * Both conversions are explained where they are used: degreesPerInch in
+     * startMove, and turnInchesPerDegree in turnAngle
+     */
+    wheelDiameter = wD;
+    baseWidth = bW;
+    degreesPerInch = 360/(wheelDiameter * 3.1415);
+    turnInchesPerDegree = (3.1415/180) * (baseWidth / 2);
+}
+
+/**
+ * Combines the readings of the encoders on one side, throwing out the ones
+ * that disagree with the rest by more than tolerance. With three or more
+ * readings, the ones too far from the median are thrown out and the rest are
+ * averaged. With two there is no majority, so if they disagree the one
+ * closer to 0 is kept: a wheel that slips spins faster than the ground
+ * moves, and an encoder that has just been reset by a reconnect jumps by its
+ * whole position
+ * @param values The readings, which are reordered
+ * @param count The number of readings
+ * @param rejected Counts the readings thrown out
+ */
+static double combine(double * values, int count, double tolerance, std::atomic<uint32_t> & rejected)
+{
+    if(count == 0) return 0;
+    if(count == 1) return values[0];
+    if(count == 2) {
+        if(std::abs(values[0] - values[1]) <= tolerance) return (values[0] + values[1]) / 2;
+        rejected++;
+        return std::abs(values[0]) < std::abs(values[1]) ? values[0] : values[1];
+    }
+    std::sort(values, values + count);
+    double median = values[count / 2];
+    double total = 0;
+    int kept = 0;
+    for(int i = 0; i < count; i++) {
+        if(std::abs(values[i] - median) <= tolerance) {
+            total += values[i];
+            kept++;
+        }
+        else rejected++;
+    }
+    return total / kept;
+}
+
+TankDrive::SideState TankDrive::fuse(const std::vector<int> & ports, EncoderFusion & fusion)
+{
+    /**
+     * The encoders on a side don't start at the same value, so each one's
+     * change since the last update is fused rather than its position, and
+     * the side's position is the sum of the fused changes. An encoder that
+     * returns PROS_ERR_F (it is unplugged) is left out, and so is its first
+     * reading after it comes back, as it has nothing to be compared to
+     */
+    constexpr int maxPorts = 8;
+    double deltas[maxPorts];
+    double velocities[maxPorts];
+    int deltaCount = 0, velocityCount = 0, healthy = 0;
+    for(int i = 0; i < (int)ports.size() && i < maxPorts; i++) {
+        double pos = pros::c::motor_get_position(ports[i]);
+        double vel = pros::c::motor_get_actual_velocity(ports[i]);
+        bool valid = pos != PROS_ERR_F;
+        if(valid) healthy++;
+        if(valid && fusion.lastValid[i]) deltas[deltaCount++] = pos - fusion.last[i];
+        if(valid && vel != PROS_ERR_F) velocities[velocityCount++] = vel;
+        fusion.last[i] = pos;
+        fusion.lastValid[i] = valid;
+    }
+    fusion.position += combine(deltas, deltaCount, positionTolerance, rejectedReadings);
+    return {fusion.position, combine(velocities, velocityCount, velocityTolerance, rejectedReadings), healthy};
+}
+
+void TankDrive::updateEncoders()
+{
+    PROFILE_SCOPE("TankDrive::updateEncoders");
+    sides.write({fuse(leftMotorPorts, leftFusion), fuse(rightMotorPorts, rightFusion)});
+}
+
+TankDrive::SideState TankDrive::getLeftState()
+{
+    return sides.read().left;
+}
+
+TankDrive::SideState TankDrive::getRightState()
+{
+    return sides.read().right;
+}
+
+double TankDrive::getLeftPosition()
+{
+    return getLeftState().position;
+}
+
+double TankDrive::getRightPosition()
+{
+    return getRightState().position;
+}
+
+uint32_t TankDrive::getRejectedReadings()
+{
+    return rejectedReadings;
+}
+
+uint32_t TankDrive::getSlipEvents()
+{
+    return traction.getSlipEvents();
+}
+
+double TankDrive::updateTraction()
+{
+    /**
+     * The IMU is read by the sensor task, so its readings come from the latest
+     * SensorFrame, and the wheels' speeds from the fused encoders. Both sides'
+     * speeds are turned from rpm into inches per second, then into the speed
+     * and turn rate of the robot, the same way as Odometry::update
+     */
+    Tasks::SensorFrame frame = Tasks::getSensorFrame();
+    uint64_t now = pros::c::micros();
+    double dt = lastTractionTime == 0 ? 0 : (now - lastTractionTime) / 1e6;
+    lastTractionTime = now;
+    double left = degreesToInches(getLeftState().velocity * 6);
+    double right = degreesToInches(getRightState().velocity * 6);
+    double turnRate = (left - right) / baseWidth * 180 / M_PI;
+    double accel = frame.forwardAccel == PROS_ERR_F ? PROS_ERR_F : frame.forwardAccel * Inertial::gravity;
+    return traction.update((left + right) / 2, turnRate, accel, frame.yawRate, dt);
+}
+
+double TankDrive::getTurnLength(double angle)
+{
+    //The same arc length conversion as turnAngle, explained below
+    return angle * turnInchesPerDegree;
 }
 
 void TankDrive::setVelocity(int leftVelo, int rightVelo)
 {
+    PROFILE_SCOPE("TankDrive::setVelocity");
     for(int p : leftMotorPorts) {
         pros::c::motor_move_velocity(p, leftVelo);
     }
@@ -135,6 +534,7 @@ void TankDrive::setVelocity(int leftVelo, int rightVelo)
 
 void TankDrive::setVoltage(int leftVolt, int rightVolt)
 {
+    PROFILE_SCOPE("TankDrive::setVoltage");
     for(int p : leftMotorPorts) {
         pros::c::motor_move_voltage(p, leftVolt);
     }
@@ -143,8 +543,9 @@ void TankDrive::setVoltage(int leftVolt, int rightVolt)
     }
 }
 
-void TankDrive::moveStraight(double distance)
+void TankDrive::moveStraight(double distance, MoveMode mode)
 {
+    PROFILE_SCOPE("TankDrive::moveStraight");
     /**
      * The moveStraight function just slightly simplifies the drivePID
      * function, cutting down on a paramter. This is purely added for
@@ -153,11 +554,12 @@ void TankDrive::moveStraight(double distance)
      * private, as, in my mind, it makes sense for an object's PID controller
      * to be kept private.
      */ 
-    drivePID(distance, distance);
+    drivePID(distance, distance, mode);
 }
 
-void TankDrive::turnAngle(double angle)
+void TankDrive::turnAngle(double angle, MoveMode mode)
 {
+    PROFILE_SCOPE("TankDrive::turnAngle");
     /**
      * The distance each side needs to rotate can be found with the 
      * arc length equation s = r * theta, where theta is the angle
@@ -166,12 +568,12 @@ void TankDrive::turnAngle(double angle)
      * This equation works because the robot turns around a point,
      * so while it might not be perfectly accurate, it is more than a
      * good enough approximation.
-     * Relating the equation with the statement below, baseWidth is r * 2, so
-     * we divide the baseWidth by 2, angle * (3.1415/180) is theta 
-     * (as the angle passed in is degrees, and the arc length equation 
-     * uses radians), and turnLength is s
+     * Relating the equation with turnInchesPerDegree (worked out in
+     * setGeometry), baseWidth is r * 2, so we divide the baseWidth by 2,
+     * angle * (3.1415/180) is theta (as the angle passed in is degrees, and
+     * the arc length equation uses radians), and turnLength is s
      */ 
-    double turnLength = angle * (3.1415/180) * (baseWidth / 2);
+    double turnLength = angle * turnInchesPerDegree;
     /**
      * As stated in TankDrive.hpp, a positive angle will make the robot
      * turn clockwise. To achieve this, the left side of the base must 
@@ -180,7 +582,14 @@ void TankDrive::turnAngle(double angle)
      * so the right side goes forward, and the left goes backward, turning
      * the robot counterclockwise
      */ 
-    drivePID(turnLength, -turnLength);
+    drivePID(turnLength, -turnLength, mode);
+}
+
+std::vector<int> TankDrive::getMotorPorts()
+{
+    std::vector<int> ports = leftMotorPorts;
+    ports.insert(ports.end(), rightMotorPorts.begin(), rightMotorPorts.end());
+    return ports;
 }
 /**
 void TankDrive::updateLeftTelemetry()
@@ -0,0 +1,177 @@
+#include "main.h"
+#include <atomic>
+#include <malloc.h>
+
+/**
+ * The implementation of the TaskMonitor namespace
+ * This file contains the source code for the TaskMonitor functions, along with
+ * explanations of how each function works
+ */
+
+/**
+ * Everything recorded about one registered task. busyUs and maxWorkUs are
+ * written by the task itself and read by the sampling task, so they are atomic.
+ * ready is set last, so a slot is never read while it is half filled in. The
+ * rest is only used by the sampling task
+ */
+struct Slot
+{
+    const char * name;
+    uint32_t stackBytes;
+    uintptr_t stackTop;
+    std::atomic<uint32_t> busyUs;
+    std::atomic<uint32_t> maxWorkUs;
+    uint32_t workStart;
+    //The busy time at the last sample, and the results of the last sample
+    uint32_t lastBusyUs;
+    double cpu;
+    uint32_t stackUsed;
+    bool stackKnown;
+    std::atomic<bool> ready;
+};
+
+/**
+ * The results of the last sample, published for other tasks (like the GUI)
+ * to read without waiting for the sampling task
+ */
+struct Results
+{
+    TaskMonitor::TaskStats tasks[TaskMonitor::maxTasks];
+    int count;
+};
+
+static Slot slots[TaskMonitor::maxTasks];
+static std::atomic<int> slotCount(0);
+static uint64_t lastSampleUs = 0;
+static DoubleBuffer<Results> results;
+/**
+ * How far above the stack position add() sees the real top of the stack might
+ * be, in bytes. It covers the frames of PROS's task wrapper, the task's function
+ * and add() itself. See checkStack()
+ */
+static constexpr uint32_t topMargin = 1024;
+//The byte FreeRTOS fills a new stack with
+static constexpr uint32_t stackFill = 0xa5a5a5a5;
+
+int TaskMonitor::add(const char * name, uint32_t stackDepth) {
+    /**
+     * The address of a local variable is almost the top of the stack, as
+     * this is called at the very start of the task. The stack grows down
+     * from there
+     */
+    volatile uint32_t marker = 0;
+    int id = -1;
+    for(int i = 0; i < slotCount; i++) {
+        if(slots[i].ready && strcmp(slots[i].name, name) == 0) id = i;
+    }
+    if(id < 0) {
+        id = slotCount.fetch_add(1);
+        if(id >= maxTasks) {
+            slotCount = maxTasks;
+            return -1;
+        }
+    }
+    Slot & s = slots[id];
+    s.ready = false;
+    s.name = name;
+    s.stackBytes = stackDepth * 4;
+    s.stackTop = (uintptr_t)&marker;
+    s.busyUs = 0;
+    s.maxWorkUs = 0;
+    s.workStart = 0;
+    s.lastBusyUs = 0;
+    s.cpu = 0;
+    s.stackUsed = 0;
+    s.stackKnown = false;
+    s.ready = true;
+    return id;
+}
+
+void TaskMonitor::beginWork(int id) {
+    if(id < 0) return;
+    slots[id].workStart = pros::c::micros();
+}
+
+void TaskMonitor::endWork(int id) {
+    if(id < 0) return;
+    Slot & s = slots[id];
+    uint32_t elapsed = (uint32_t)pros::c::micros() - s.workStart;
+    s.busyUs += elapsed;
+    if(elapsed > s.maxWorkUs) s.maxWorkUs = elapsed;
+}
+
+/**
+ * Finds how much of a task's stack has been used. The lowest address checked
+ * is topMargin bytes above where the bottom of the stack would be if add() had
+ * seen the real top, so it is always inside the stack. From there, words still
+ * holding the fill are counted up to the first one that doesn't. The result is
+ * rounded up by up to topMargin bytes, so it never under-reports
+ */
+static void checkStack(Slot & s) {
+    uintptr_t bottom = (s.stackTop - s.stackBytes + topMargin + 3) & ~(uintptr_t)3;
+    const volatile uint32_t * p = (const volatile uint32_t *)bottom;
+    const volatile uint32_t * top = (const volatile uint32_t *)s.stackTop;
+    if(*p != stackFill) {
+        s.stackKnown = false;
+        return;
+    }
+    while(p < top && *p == stackFill) p++;
+    s.stackKnown = true;
+    s.stackUsed = s.stackTop - (uintptr_t)p + topMargin;
+}
+
+void TaskMonitor::sample() {
+    uint64_t now = pros::c::micros();
+    uint32_t window = now - lastSampleUs;
+    lastSampleUs = now;
+    Results r;
+    r.count = 0;
+    for(int i = 0; i < slotCount; i++) {
+        Slot & s = slots[i];
+        if(!s.ready) continue;
+        uint32_t busy = s.busyUs;
+        s.cpu = window > 0 ? 100.0 * (busy - s.lastBusyUs) / window : 0;
+        s.lastBusyUs = busy;
+        checkStack(s);
+        r.tasks[r.count++] = {s.name, s.cpu, s.maxWorkUs, s.stackBytes, s.stackUsed, s.stackKnown};
+    }
+    results.write(r);
+}
+
+int TaskMonitor::getTaskStats(TaskStats * out, int max) {
+    //The copy is taken from the published results, so it is never half way through a sample
+    Results r = results.read();
+    int count = r.count < max ? r.count : max;
+    for(int i = 0; i < count; i++) {
+        out[i] = r.tasks[i];
+    }
+    return count;
+}
+
+TaskMonitor::HeapStats TaskMonitor::getHeapStats() {
+    struct mallinfo mi = mallinfo();
+    lv_mem_monitor_t lv;
+    lv_mem_monitor(&lv);
+    return {(uint32_t)mi.arena, (uint32_t)mi.uordblks, (uint32_t)mi.fordblks,
+            lv.total_size, lv.total_size - lv.free_size, lv.frag_pct};
+}
+
+void TaskMonitor::print() {
+    TaskStats stats[maxTasks];
+    int count = getTaskStats(stats, maxTasks);
+    for(int i = 0; i < count; i++) {
+        const TaskStats & t = stats[i];
+        if(t.stackKnown) {
+            printf("\n[tasks] %-16s cpu %5.1f%%  max %6u us  stack %6u/%u B", t.name, t.cpu,
+                   (unsigned)t.maxWorkUs, (unsigned)t.stackUsed, (unsigned)t.stackBytes);
+        }
+        else {
+            printf("\n[tasks] %-16s cpu %5.1f%%  max %6u us  stack ?/%u B", t.name, t.cpu,
+                   (unsigned)t.maxWorkUs, (unsigned)t.stackBytes);
+        }
+    }
+    HeapStats h = getHeapStats();
+    printf("\n[heap] used %u B, free %u B of %u B; lvgl used %u B of %u B, %u%% fragmented\n",
+           (unsigned)h.heapUsed, (unsigned)h.heapFree, (unsigned)h.heapTotal,
+           (unsigned)h.lvglUsed, (unsigned)h.lvglTotal, (unsigned)h.lvglFragPct);
+}
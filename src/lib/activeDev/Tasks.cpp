@@ -0,0 +1,246 @@
+#include "main.h"
+#include <atomic>
+
+/**
+ * The implementation of the Tasks namespace
+ * This file contains the source code for the Tasks functions, along with
+ * explanations of how each function works
+ */
+
+//The values published by the sensor and control tasks, each of which is the only writer of its buffer
+static DoubleBuffer<Tasks::SensorFrame> sensorFrame;
+static DoubleBuffer<Tasks::ControlStats> controlStats;
+static std::atomic<bool> driverControl(false);
+//Whether something other than driver control is driving the robot (see Tasks.hpp)
+static std::atomic<bool> robotClaimed(false);
+static pros::task_t controlTask = NULL;
+static pros::task_t sensorTask = NULL;
+static pros::task_t odometryTask = NULL;
+static pros::task_t jamTask = NULL;
+static pros::task_t localizerTask = NULL;
+static pros::task_t loggingTask = NULL;
+
+/**
+ * The control task wakes up every period whether or not there is anything to
+ * do, so its timing is always being measured. During driver control it runs
+ * one Pipeline tick from the latest SensorFrame, which is never more than one
+ * sensor period old
+ */
+static void controlFn(void * param) {
+    int monitorId = TaskMonitor::add(Tasks::control.name, Tasks::control.stackDepth);
+    Tasks::ControlStats stats = {0, 0, 0, 0, 0};
+    uint32_t now = pros::c::millis();
+    uint64_t lastWake = 0;
+    while(true) {
+        pros::c::task_delay_until(&now, Tasks::control.period);
+        /**
+         * millis() and micros() come from different timers, so the jitter is
+         * measured between two wake-ups on the micros() timer instead of
+         * against the time task_delay_until was asked for
+         */
+        uint64_t wake = pros::c::micros();
+        if(lastWake != 0) {
+            int64_t error = (int64_t)(wake - lastWake) - Tasks::control.period * 1000;
+            stats.lastJitterUs = error < 0 ? -error : error;
+            if(stats.lastJitterUs > stats.maxJitterUs) stats.maxJitterUs = stats.lastJitterUs;
+        }
+        lastWake = wake;
+
+        TaskMonitor::beginWork(monitorId);
+        bool disabled = (pros::c::competition_get_status() & COMPETITION_DISABLED) != 0;
+        if(driverControl && !disabled) {
+            Tasks::SensorFrame frame = sensorFrame.read();
+            recorder.record(frame.controller);
+            Pipeline::tick(frame);
+        }
+        TaskMonitor::endWork(monitorId);
+
+        uint32_t work = pros::c::micros() - wake;
+        if(work > stats.maxWorkUs) stats.maxWorkUs = work;
+        if(work > Tasks::control.period * 1000) stats.overruns++;
+        stats.ticks++;
+        controlStats.write(stats);
+    }
+}
+
+/**
+ * Each frame is published as soon as it is read, then the odometry task is
+ * woken to use it, so the pose is never more than one frame behind
+ */
+static void sensorFn(void * param) {
+    int monitorId = TaskMonitor::add(Tasks::sensors.name, Tasks::sensors.stackDepth);
+    uint32_t now = pros::c::millis();
+    while(true) {
+        TaskMonitor::beginWork(monitorId);
+        Tasks::SensorFrame frame;
+        frame.controller = ControllerState::read(CONTROLLER_MASTER);
+        drive.updateEncoders();
+        TankDrive::SideState left = drive.getLeftState();
+        TankDrive::SideState right = drive.getRightState();
+        frame.leftPos = left.position;
+        frame.rightPos = right.position;
+        frame.leftVel = left.velocity;
+        frame.rightVel = right.velocity;
+        frame.yawRate = imu.getYawRate();
+        frame.forwardAccel = imu.getForwardAccel();
+        frame.pitch = imu.getPitch();
+        frame.roll = imu.getRoll();
+        frame.indexer = indexer.getState();
+        frame.time = pros::c::micros();
+        sensorFrame.write(frame);
+        if(odometryTask != NULL) pros::c::task_notify(odometryTask);
+        TaskMonitor::endWork(monitorId);
+        pros::c::task_delay_until(&now, Tasks::sensors.period);
+    }
+}
+
+/**
+ * The odometry task sleeps until the sensor task has a new frame. It gives up
+ * waiting after two periods, so it still runs if the sensor task stops
+ */
+static void odometryFn(void * param) {
+    int monitorId = TaskMonitor::add(Tasks::odometry.name, Tasks::odometry.stackDepth);
+    uint32_t lastFrame = 0;
+    while(true) {
+        pros::c::task_notify_take(true, Tasks::odometry.period * 2);
+        uint32_t frames = sensorFrame.getWrites();
+        if(frames == lastFrame) continue;
+        lastFrame = frames;
+        TaskMonitor::beginWork(monitorId);
+        Tasks::SensorFrame frame = sensorFrame.read();
+        odom.update(frame.leftPos, frame.rightPos);
+        ekf.update(frame);
+        TaskMonitor::endWork(monitorId);
+    }
+}
+
+/**
+ * The jam task watches both mechanisms, whichever task is driving them, in
+ * driver control and autonomous alike. Both are paused while the Indexer
+ * ejects a ball, as it runs them backwards against the ball on purpose
+ */
+static void jamFn(void * param) {
+    int monitorId = TaskMonitor::add(Tasks::jams.name, Tasks::jams.stackDepth);
+    uint32_t now = pros::c::millis();
+    while(true) {
+        pros::c::task_delay_until(&now, Tasks::jams.period);
+        TaskMonitor::beginWork(monitorId);
+        bool ejecting = indexer.getState() == IndexerState::ejecting;
+        intake.getJamDetector().update(ejecting);
+        conveyor.getJamDetector().update(ejecting);
+        TaskMonitor::endWork(monitorId);
+    }
+}
+
+/**
+ * The localizer reads the odometry's latest pose rather than waiting for each
+ * frame, as it only needs to keep up with the robot, not with every frame
+ */
+static void localizerFn(void * param) {
+    int monitorId = TaskMonitor::add(Tasks::localizer.name, Tasks::localizer.stackDepth);
+    uint32_t now = pros::c::millis();
+    while(true) {
+        pros::c::task_delay_until(&now, Tasks::localizer.period);
+        TaskMonitor::beginWork(monitorId);
+        localizer.update();
+        TaskMonitor::endWork(monitorId);
+    }
+}
+
+/**
+ * Printing to the terminal can take milliseconds, and writing to the microSD
+ * card hundreds of them, which is why both are only done here, in the lowest
+ * priority task. A recording the control task has finished is saved here
+ */
+static void loggingFn(void * param) {
+    int monitorId = TaskMonitor::add(Tasks::logging.name, Tasks::logging.stackDepth);
+    uint32_t now = pros::c::millis();
+    while(true) {
+        pros::c::task_delay_until(&now, Tasks::logging.period);
+        TaskMonitor::beginWork(monitorId);
+        recorder.flush();
+        TaskMonitor::sample();
+        TaskMonitor::print();
+        Tasks::ControlStats c = Tasks::getControlStats();
+        Pose p = odom.getPose();
+        PoseEKF::Estimate e = ekf.getEstimate();
+        Localizer::Estimate l = localizer.getEstimate();
+        printf("[control] %u ticks, jitter %u us (max %u us), max work %u us, %u overruns\n",
+               (unsigned)c.ticks, (unsigned)c.lastJitterUs, (unsigned)c.maxJitterUs,
+               (unsigned)c.maxWorkUs, (unsigned)c.overruns);
+        printf("[pose] x %.2f in, y %.2f in, heading %.1f deg\n", p.x, p.y, p.theta);
+        printf("[ekf] x %.2f in, y %.2f in, heading %.1f deg, %.1f in/s, %.1f deg/s, %u rejected\n",
+               e.pose.x, e.pose.y, e.pose.theta, e.velocity, e.turnRate, (unsigned)ekf.getRejected());
+        printf("[field] x %.2f in, y %.2f in, heading %.1f deg, spread %.2f in%s, %u corrections\n",
+               l.pose.x, l.pose.y, l.pose.theta, l.spread, l.sensed ? "" : " (no readings)",
+               (unsigned)odom.getCorrections());
+        TipGuard::Stats g = tipGuard.getStats();
+        printf("[tipguard] %u of %u ticks held (%u holds, longest %u ms), %u tips\n",
+               (unsigned)g.heldTicks, (unsigned)g.ticks, (unsigned)g.holds, (unsigned)g.maxHoldMs, (unsigned)g.tips);
+        sorter.printReport();
+        JamDetector::Stats ij = intake.getJamDetector().getStats();
+        JamDetector::Stats cj = conveyor.getJamDetector().getStats();
+        printf("[jams] intake %u (%u repeats, %u given up, last port %d), conveyor %u (%u repeats, %u given up, last port %d)\n",
+               (unsigned)ij.jams, (unsigned)ij.repeats, (unsigned)ij.giveUps, ij.lastPort,
+               (unsigned)cj.jams, (unsigned)cj.repeats, (unsigned)cj.giveUps, cj.lastPort);
+        printf("[traction] %u slip events, %u encoder readings rejected\n",
+               (unsigned)drive.getSlipEvents(), (unsigned)drive.getRejectedReadings());
+        TaskMonitor::endWork(monitorId);
+    }
+}
+
+/**
+ * A helper that creates a task from its entry in the table
+ */
+static pros::task_t create(pros::task_fn_t fn, const Tasks::Config & config) {
+    return pros::c::task_create(fn, NULL, config.priority, config.stackDepth, config.name);
+}
+
+void Tasks::start() {
+    /**
+     * The odometry task is created before the sensor task, so the sensor
+     * task has something to wake from its very first frame
+     */
+    if(odometryTask == NULL) odometryTask = create(odometryFn, odometry);
+    if(sensorTask == NULL) sensorTask = create(sensorFn, sensors);
+    if(controlTask == NULL) controlTask = create(controlFn, control);
+    if(jamTask == NULL) jamTask = create(jamFn, jams);
+    if(localizerTask == NULL) localizerTask = create(localizerFn, localizer);
+    if(loggingTask == NULL) loggingTask = create(loggingFn, logging);
+}
+
+void Tasks::setDriverControl(bool enabled) {
+    driverControl = enabled;
+}
+
+bool Tasks::isDriverControl() {
+    return driverControl;
+}
+
+bool Tasks::tryClaimRobot() {
+    return !robotClaimed.exchange(true);
+}
+
+void Tasks::claimRobot() {
+    while(!tryClaimRobot()) pros::delay(5);
+}
+
+void Tasks::releaseRobot() {
+    robotClaimed = false;
+}
+
+bool Tasks::isRobotClaimed() {
+    return robotClaimed;
+}
+
+Tasks::SensorFrame Tasks::getSensorFrame() {
+    return sensorFrame.read();
+}
+
+Tasks::ControlStats Tasks::getControlStats() {
+    return controlStats.read();
+}
+
+void Tasks::raiseToControl() {
+    pros::c::task_set_priority(pros::c::task_get_current(), control.priority);
+}
@@ -0,0 +1,142 @@
+#include "main.h"
+
+/**
+ * The implementation of the Timeline namespace
+ * This file contains the source code for the Timeline functions, along with
+ * explanations of how each function works
+ */
+
+//The recorded entries and how many there are
+static Timeline::Entry entries[Timeline::maxEntries];
+static int entryCount = 0;
+//How many recorded commands are currently running, used to find each new entry's depth
+static int openCount = 0;
+//The time the routine started, whether the clock is simulated, and the simulated time
+static uint32_t startTime = 0;
+static bool simulating = false;
+static uint32_t simTime = 0;
+static Pose simPose = {0, 0, 0};
+
+void Timeline::clear() {
+    entryCount = 0;
+    openCount = 0;
+    startTime = now();
+}
+
+int Timeline::begin(const char * name, Kind kind) {
+    if(entryCount >= maxEntries) return -1;
+    /**
+     * Every command that has started but not finished contains the new one
+     * (commands inside a group always end before the group does), so the
+     * number of open commands is the depth of the new one
+     */
+    entries[entryCount] = {name, kind, (uint8_t)openCount, now() - startTime, 0, true};
+    openCount++;
+    return entryCount++;
+}
+
+void Timeline::finish(int index) {
+    openCount--;
+    if(index < 0) return;
+    entries[index].end = now() - startTime;
+    entries[index].running = false;
+}
+
+int Timeline::size() {
+    return entryCount;
+}
+
+const Timeline::Entry & Timeline::get(int index) {
+    return entries[index];
+}
+
+const char * Timeline::currentAction() {
+    for(int i = entryCount - 1; i >= 0; i--) {
+        if(entries[i].kind == Kind::action && entries[i].running) return entries[i].name;
+    }
+    return NULL;
+}
+
+uint32_t Timeline::elapsed() {
+    return now() - startTime;
+}
+
+bool Timeline::isIdleWait(int index) {
+    const Entry & w = entries[index];
+    if(w.kind != Kind::wait || w.end <= w.start) return false;
+    for(int i = 0; i < entryCount; i++) {
+        const Entry & e = entries[i];
+        if(e.kind == Kind::action && e.start < w.end && e.end > w.start) return false;
+    }
+    return true;
+}
+
+void Timeline::writeJson(FILE * f, const char * routine) {
+    /**
+     * The end of the routine is the latest end of any entry. Idle waits are
+     * listed by their index in steps, and their total is given so it can be
+     * tracked from one version of the code to the next
+     */
+    uint32_t total = 0;
+    uint32_t idle = 0;
+    for(int i = 0; i < entryCount; i++) {
+        if(entries[i].end > total) total = entries[i].end;
+        if(isIdleWait(i)) idle += entries[i].end - entries[i].start;
+    }
+    fprintf(f, "{\"routine\":\"%s\",\"simulated\":%s,\"total_ms\":%u,\"idle_wait_ms\":%u,\"steps\":[",
+            routine, simulating ? "true" : "false", (unsigned)total, (unsigned)idle);
+    for(int i = 0; i < entryCount; i++) {
+        const Entry & e = entries[i];
+        const char * kind = e.kind == Kind::group ? "group" : e.kind == Kind::wait ? "wait" : "action";
+        fprintf(f, "%s{\"name\":\"%s\",\"kind\":\"%s\",\"depth\":%d,\"start_ms\":%u,\"end_ms\":%u}",
+                i == 0 ? "" : ",", e.name, kind, e.depth, (unsigned)e.start, (unsigned)e.end);
+    }
+    fprintf(f, "],\"idle_waits\":[");
+    bool first = true;
+    for(int i = 0; i < entryCount; i++) {
+        if(!isIdleWait(i)) continue;
+        fprintf(f, "%s%d", first ? "" : ",", i);
+        first = false;
+    }
+    fprintf(f, "]}");
+}
+
+void Timeline::setSimulating(bool sim) {
+    simulating = sim;
+    simTime = 0;
+    simPose = {0, 0, 0};
+}
+
+bool Timeline::isSimulating() {
+    return simulating;
+}
+
+uint32_t Timeline::now() {
+    return simulating ? simTime : pros::c::millis();
+}
+
+void Timeline::advance(uint32_t ms) {
+    if(simulating) simTime += ms;
+}
+
+uint32_t Timeline::simMoveTime(double inches) {
+    /**
+     * A trapezoidal profile accelerates at simAccel up to simMaxSpeed, cruises,
+     * then slows down at the same rate. If the move is too short to reach
+     * simMaxSpeed, the profile is a triangle instead
+     */
+    double d = fabs(inches);
+    double accelDist = simMaxSpeed * simMaxSpeed / simAccel;
+    double seconds;
+    if(d < accelDist) seconds = 2 * sqrt(d / simAccel);
+    else seconds = 2 * simMaxSpeed / simAccel + (d - accelDist) / simMaxSpeed;
+    return seconds * 1000;
+}
+
+Pose Timeline::getSimPose() {
+    return simPose;
+}
+
+void Timeline::setSimPose(Pose pose) {
+    simPose = pose;
+}
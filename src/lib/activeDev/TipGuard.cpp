@@ -0,0 +1,119 @@
+#include "main.h"
+#include <cmath>
+
+/**
+ * The implementation of the TipGuard class
+ * This file contains the source code for the TipGuard class, along with
+ * explanations of how each function works
+ */
+
+TipGuard::TipGuard(double forwardAccel, double reverseAccel, double brake, double warnAngle, double tipAngle)
+    : forwardAccel(forwardAccel), reverseAccel(reverseAccel), brake(brake),
+      warnAngle(warnAngle), tipAngle(tipAngle), published({0, 0, 0, 0, 0, 0}) {
+    lastLeft = 0;
+    lastRight = 0;
+    lastTime = 0;
+    holding = false;
+    tipping = false;
+    holdTicks = 0;
+    stats = {0, 0, 0, 0, 0, 0};
+}
+
+double TipGuard::limit(double last, double target, double scale, double dt) {
+    /**
+     * Speeding up uses the limit for the way the side is going. Slowing down,
+     * or reversing, uses the brake limit as far as 0, and whatever is left of
+     * the tick after reaching 0 is spent speeding up the other way
+     */
+    if(last * target >= 0 && fabs(target) >= fabs(last)) {
+        double step = (target > 0 ? forwardAccel : reverseAccel) * scale * dt;
+        return fabs(target - last) <= step ? target : last + (target > last ? step : -step);
+    }
+    double brakeStep = brake * scale * dt;
+    if(last * target > 0) {
+        return fabs(target - last) <= brakeStep ? target : last + (target > last ? brakeStep : -brakeStep);
+    }
+    if(fabs(last) > brakeStep) return last + (last > 0 ? -brakeStep : brakeStep);
+    double left = 1 - fabs(last) / brakeStep;
+    double step = (target > 0 ? forwardAccel : reverseAccel) * scale * dt * left;
+    return fabs(target) <= step ? target : (target > 0 ? step : -step);
+}
+
+void TipGuard::shape(const Tasks::SensorFrame & frame, MotorOutputs & out) {
+    PROFILE_SCOPE("TipGuard::shape");
+    if(!out.driveSet) return;
+    /**
+     * The control task runs at a fixed period, so that is the time each step
+     * of the limits covers. The frame's time is only used to notice driver
+     * control starting again, as the motors were stopped in between
+     */
+    double dt = Tasks::control.period / 1000.0;
+    if(lastTime == 0 || frame.time - lastTime > restartGap * 1000) {
+        lastLeft = 0;
+        lastRight = 0;
+    }
+    lastTime = frame.time;
+    stats.ticks++;
+
+    /**
+     * The limits are full strength while the robot is level, and tightened the
+     * further it leans past warnAngle either way. Without the IMU, it is level
+     */
+    double pitch = frame.pitch == PROS_ERR_F ? 0 : frame.pitch;
+    double roll = frame.roll == PROS_ERR_F ? 0 : frame.roll;
+    double tilt = std::max(fabs(pitch), fabs(roll));
+    double scale = 1;
+    if(tilt > warnAngle) {
+        double t = std::min(1.0, (tilt - warnAngle) / (tipAngle - warnAngle));
+        scale = 1 - t * (1 - tightScale);
+    }
+
+    double left, right;
+    if(fabs(pitch) > tipAngle) {
+        /**
+         * With the nose up (positive pitch) the robot is going over backwards,
+         * and driving backwards puts the wheels back under it, and the other way
+         * round with the nose down. The push replaces the driver's command, and
+         * the limits carry on from it once the robot is back down
+         */
+        double push = std::min(maxRecovery, minRecovery + recoveryGain * (fabs(pitch) - tipAngle));
+        left = right = pitch > 0 ? -push : push;
+        stats.tipTicks++;
+        if(!tipping) stats.tips++;
+        tipping = true;
+    }
+    else {
+        left = limit(lastLeft, out.driveLeft, scale, dt);
+        right = limit(lastRight, out.driveRight, scale, dt);
+        tipping = false;
+    }
+    lastLeft = left;
+    lastRight = right;
+
+    /**
+     * A tick whose output isn't the driver's command is one tick of latency
+     * added by the guard. Consecutive ones make up one hold, which ends the
+     * first tick the output catches up
+     */
+    int8_t shapedLeft = (int8_t)lround(left);
+    int8_t shapedRight = (int8_t)lround(right);
+    if(shapedLeft != out.driveLeft || shapedRight != out.driveRight) {
+        stats.heldTicks++;
+        holdTicks++;
+        if(!holding) stats.holds++;
+        holding = true;
+        uint32_t holdMs = holdTicks * Tasks::control.period;
+        if(holdMs > stats.maxHoldMs) stats.maxHoldMs = holdMs;
+    }
+    else {
+        holding = false;
+        holdTicks = 0;
+    }
+    out.driveLeft = shapedLeft;
+    out.driveRight = shapedRight;
+    published.write(stats);
+}
+
+TipGuard::Stats TipGuard::getStats() {
+    return published.read();
+}
@@ -0,0 +1,68 @@
+#include "main.h"
+#include <cmath>
+
+/**
+ * The implementation of the TractionControl class
+ * This file contains the source code for the TractionControl class, along with
+ * explanations of how each function works
+ */
+
+TractionControl::TractionControl() : slipEvents(0) {
+    reset(0);
+}
+
+void TractionControl::reset(double wheelVelocity) {
+    chassisVelocity = wheelVelocity;
+    lastWheelVelocity = wheelVelocity;
+    slipTicks = 0;
+    slipping = false;
+    scale = 1;
+}
+
+double TractionControl::update(double wheelVelocity, double wheelTurnRate, double accel, double gyroRate, double dt) {
+    if(accel == PROS_ERR_F || gyroRate == PROS_ERR_F || dt <= 0) {
+        reset(wheelVelocity);
+        return 1;
+    }
+    /**
+     * The robot's speed is moved on by the IMU's acceleration before it is
+     * compared. The wheels can spin faster than the robot when pulling away,
+     * or lock up and slide when stopping, so a gap either way counts
+     */
+    chassisVelocity += accel * dt;
+    double wheelAccel = (wheelVelocity - lastWheelVelocity) / dt;
+    lastWheelVelocity = wheelVelocity;
+    double speedGap = fabs(wheelVelocity - chassisVelocity);
+    double accelGap = fabs(wheelAccel - accel);
+    double turnGap = fabs(wheelTurnRate) - fabs(gyroRate);
+    bool slipNow = speedGap > std::max(slipSpeed, slipFraction * fabs(wheelVelocity)) ||
+                   accelGap > slipAccel ||
+                   turnGap > std::max(slipTurnRate, slipFraction * fabs(wheelTurnRate));
+
+    slipTicks = slipNow ? slipTicks + 1 : 0;
+    if(slipTicks >= detectTicks) {
+        if(!slipping) slipEvents++;
+        slipping = true;
+        scale = std::max(minScale, scale * backoff);
+    }
+    else {
+        /**
+         * While the wheels grip, they are the better measure of the robot's
+         * speed, so the IMU's is pulled towards them to stop it drifting. It is
+         * left alone on an update that only looks like slip, so a real slip
+         * isn't hidden before it is confirmed
+         */
+        slipping = false;
+        scale = std::min(1.0, scale + recovery);
+        if(!slipNow) chassisVelocity += anchor * (wheelVelocity - chassisVelocity);
+    }
+    return scale;
+}
+
+bool TractionControl::isSlipping() {
+    return slipping;
+}
+
+uint32_t TractionControl::getSlipEvents() {
+    return slipEvents;
+}
@@ -0,0 +1,193 @@
+#include "main.h"
+#include <cmath>
+
+/**
+ * The implementation of the Trajectory class
+ * This file contains the source code for the Trajectory class, along with
+ * explanations of how each function works
+ */
+
+Trajectory::Trajectory() {
+    stateCount = 0;
+}
+
+Trajectory::Limits Trajectory::limitsFor(TankDrive & drive, double maxAccel, double maxLateralAccel,
+                                         double speedFraction) {
+    //The gearset's top speed in rpm is turned into degrees per second, then inches per second
+    double wheelMax = drive.degreesToInches(drive.getMaxRpm() * 6) * speedFraction;
+    return {wheelMax, maxAccel, maxLateralAccel, wheelMax, drive.getBaseWidth()};
+}
+
+bool Trajectory::plan(const Point * points, int count, double spacing, const Limits & limits,
+                      double startVelocity, double endVelocity) {
+    PROFILE_SCOPE("Trajectory::plan");
+    stateCount = 0;
+    if(count < 2 || spacing <= 0) return false;
+
+    /**
+     * A Catmull-Rom spline is fitted through the points: the curve between
+     * two points is a cubic set by them and the points either side, so it
+     * passes through every point and its direction changes smoothly. The
+     * first and last points are mirrored to make the missing neighbours, so
+     * the path starts and ends heading along its first and last segments
+     */
+    auto control = [&](int i) -> Point {
+        if(i < 0) return {2 * points[0].x - points[1].x, 2 * points[0].y - points[1].y};
+        if(i >= count) return {2 * points[count - 1].x - points[count - 2].x, 2 * points[count - 1].y - points[count - 2].y};
+        return points[i];
+    };
+
+    auto segmentLength = [&](int i) {
+        return sqrt((points[i + 1].x - points[i].x) * (points[i + 1].x - points[i].x) +
+                    (points[i + 1].y - points[i].y) * (points[i + 1].y - points[i].y));
+    };
+    //Two points in the same place would add rows with no distance between them, so those segments are skipped
+    int lastSegment = -1;
+    for(int i = 0; i + 1 < count; i++) {
+        if(segmentLength(i) > 1e-9) lastSegment = i;
+    }
+    if(lastSegment < 0) return false;
+
+    /**
+     * Each segment is split into steps of about spacing inches, and a row added
+     * at the start of each step, then one for the last point. The heading (a
+     * compass heading, like the Pose's) and the curvature come from the
+     * spline's first and second derivatives, so they don't depend on spacing.
+     * The curvature is how much the heading changes per inch, which is
+     * (y' * x'' - x' * y'') / speed^3 for a compass heading, positive for
+     * clockwise turns. The distance is summed along the rows
+     */
+    int n = 0;
+    double distance = 0;
+    for(int i = 0; i <= lastSegment; i++) {
+        Point p0 = control(i - 1), p1 = points[i], p2 = points[i + 1], p3 = control(i + 2);
+        double length = segmentLength(i);
+        if(length <= 1e-9) continue;
+        int steps = std::max(1, (int)ceil(length / spacing));
+        if(n + steps + 1 > maxPoints) return false;
+        //The spline is 0.5 * (2 p1 + b t + c t^2 + e t^3), for x and y alike
+        double bx = p2.x - p0.x, by = p2.y - p0.y;
+        double cx = 2 * p0.x - 5 * p1.x + 4 * p2.x - p3.x, cy = 2 * p0.y - 5 * p1.y + 4 * p2.y - p3.y;
+        double ex = -p0.x + 3 * p1.x - 3 * p2.x + p3.x, ey = -p0.y + 3 * p1.y - 3 * p2.y + p3.y;
+        bool last = i == lastSegment;
+        for(int j = 0; j <= steps; j++) {
+            //Every segment but the last leaves its end point to the next one
+            if(j == steps && !last) break;
+            double t = (double)j / steps;
+            states[n] = {};
+            states[n].x = 0.5 * (2 * p1.x + bx * t + cx * t * t + ex * t * t * t);
+            states[n].y = 0.5 * (2 * p1.y + by * t + cy * t * t + ey * t * t * t);
+            if(n > 0) distance += sqrt((states[n].x - states[n - 1].x) * (states[n].x - states[n - 1].x) +
+                                       (states[n].y - states[n - 1].y) * (states[n].y - states[n - 1].y));
+            states[n].distance = distance;
+            double vx = 0.5 * (bx + 2 * cx * t + 3 * ex * t * t), vy = 0.5 * (by + 2 * cy * t + 3 * ey * t * t);
+            double ax = 0.5 * (2 * cx + 6 * ex * t), ay = 0.5 * (2 * cy + 6 * ey * t);
+            double speed = sqrt(vx * vx + vy * vy);
+            states[n].heading = atan2(vx, vy) * 180 / M_PI;
+            states[n].curvature = speed > 1e-9 ? (vy * ax - vx * ay) / (speed * speed * speed) : 0;
+            n++;
+        }
+    }
+    /**
+     * The highest speed at each row: the top speed, the speed at which the
+     * cornering acceleration (v^2 * curvature) reaches its limit, and the speed
+     * at which the outside wheel (v * (1 + curvature * width / 2)) reaches its
+     * top speed. The first and last rows are also held to the start and end speeds
+     */
+    for(int i = 0; i < n; i++) {
+        double k = fabs(states[i].curvature);
+        double v = limits.maxVelocity;
+        if(k > 1e-9) v = std::min(v, sqrt(limits.maxLateralAccel / k));
+        v = std::min(v, limits.wheelMaxVelocity / (1 + k * limits.trackWidth / 2));
+        states[i].velocity = v;
+    }
+    states[0].velocity = std::min(states[0].velocity, startVelocity);
+    states[n - 1].velocity = std::min(states[n - 1].velocity, endVelocity);
+
+    /**
+     * The forwards pass keeps the speed from rising faster than the robot can
+     * speed up, and the backwards pass keeps it from falling faster than it can
+     * slow down, from v^2 = u^2 + 2as. The grip left for speeding up or slowing
+     * down is whatever cornering doesn't use: (a / maxAccel)^2 + (lateral /
+     * maxLateralAccel)^2 can't be more than 1
+     */
+    for(int i = 1; i < n; i++) {
+        double ds = states[i].distance - states[i - 1].distance;
+        double u = states[i - 1].velocity;
+        double lateral = u * u * fabs(states[i - 1].curvature) / limits.maxLateralAccel;
+        double accel = limits.maxAccel * sqrt(std::max(0.0, 1 - lateral * lateral));
+        states[i].velocity = std::min(states[i].velocity, sqrt(u * u + 2 * accel * ds));
+    }
+    for(int i = n - 2; i >= 0; i--) {
+        double ds = states[i + 1].distance - states[i].distance;
+        double u = states[i + 1].velocity;
+        double lateral = u * u * fabs(states[i + 1].curvature) / limits.maxLateralAccel;
+        double accel = limits.maxAccel * sqrt(std::max(0.0, 1 - lateral * lateral));
+        states[i].velocity = std::min(states[i].velocity, sqrt(u * u + 2 * accel * ds));
+    }
+
+    /**
+     * With constant acceleration over each step, the time it takes is the
+     * distance over the average speed. A step from standing still to standing
+     * still can only come from a corner, and is timed as speeding up over half
+     * and slowing down over the other half
+     */
+    states[0].time = 0;
+    for(int i = 1; i < n; i++) {
+        double ds = states[i].distance - states[i - 1].distance;
+        double sum = states[i - 1].velocity + states[i].velocity;
+        double dt = sum > 1e-6 ? 2 * ds / sum : 2 * sqrt(ds / limits.maxAccel);
+        states[i].time = states[i - 1].time + dt;
+        states[i - 1].accel = (states[i].velocity * states[i].velocity -
+                               states[i - 1].velocity * states[i - 1].velocity) / (2 * ds);
+    }
+    for(int i = 0; i < n; i++) {
+        double offset = states[i].curvature * limits.trackWidth / 2;
+        states[i].leftVelocity = states[i].velocity * (1 + offset);
+        states[i].rightVelocity = states[i].velocity * (1 - offset);
+    }
+    stateCount = n;
+    return true;
+}
+
+int Trajectory::size() {
+    return stateCount;
+}
+
+const Trajectory::State & Trajectory::get(int index) {
+    return states[index];
+}
+
+double Trajectory::getDuration() {
+    return stateCount == 0 ? 0 : states[stateCount - 1].time;
+}
+
+Trajectory::State Trajectory::sample(double time) {
+    /**
+     * The rows are in time order, so the two either side of the time are
+     * found with a binary search, and every value is interpolated between them
+     */
+    if(stateCount == 0) return {};
+    if(time <= 0) return states[0];
+    if(time >= states[stateCount - 1].time) return states[stateCount - 1];
+    int lo = 0, hi = stateCount - 1;
+    while(hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if(states[mid].time <= time) lo = mid;
+        else hi = mid;
+    }
+    const State & a = states[lo];
+    const State & b = states[hi];
+    double f = (time - a.time) / (b.time - a.time);
+    State s = a;
+    s.time = time;
+    s.distance = a.distance + (b.distance - a.distance) * f;
+    s.x = a.x + (b.x - a.x) * f;
+    s.y = a.y + (b.y - a.y) * f;
+    s.heading = a.heading + wrap180(b.heading - a.heading) * f;
+    s.velocity = a.velocity + (b.velocity - a.velocity) * f;
+    s.curvature = a.curvature + (b.curvature - a.curvature) * f;
+    s.leftVelocity = a.leftVelocity + (b.leftVelocity - a.leftVelocity) * f;
+    s.rightVelocity = a.rightVelocity + (b.rightVelocity - a.rightVelocity) * f;
+    return s;
+}
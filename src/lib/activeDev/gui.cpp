@@ -17,7 +17,7 @@
  * a button in the matrix, while the \n characters indicate a switch
  * to a new line
  */ 
-const char * autonMap[] = {"None", "\n", "Test", "Skills", "\n", "Left", "Mid to Left", "\n", "Right", "Mid to Right", ""};
+const char * autonMap[] = {"None", "\n", "Test", "Skills", "\n", "Left", "Mid to Left", "\n", "Right", "Mid to Right", "\n", "Replay", ""};
 
 /**
  * The character array used by LVGL to hold the options in the
@@ -25,13 +25,19 @@ const char * autonMap[] = {"None", "\n", "Test", "Skills", "\n", "Left", "Mid to
  * a button in the matrix.
  * 
  */ 
-const char * debugMap[] = {""};
+const char * debugMap[] = {"Tasks", "Profile", ""};
+/**
+ * The character array used by LVGL to hold the options in the color
+ * sorting menu. The opponent's color is selected, as that is the color
+ * the ColorSorter throws out
+ */ 
+const char * sortMap[] = {"Red", "\n", "Blue", "\n", "No Sort", ""};
 /**
  * The enumerator used to store the ID of the current selected autonomous
  * It is set to value none by default so that if an autonomous routine is
  * not selected, the robot does not run an autonomous routine.
  */
-Auton autonID = Auton::none;
+std::atomic<Auton> autonID(Auton::none);
 /**
  * The LVGL objects for the GUI's screens.
  */ 
@@ -108,6 +114,10 @@ lv_obj_t * autonMenu;
 lv_obj_t * curAutonLbl;
 //A button to run the current autonomous selected. Used for testing
 lv_obj_t * autonRunBtn;
+//A label showing the progress of an autonomous started with autonRunBtn
+lv_obj_t * autonProgressLbl;
+//The button matrix used to select the color of ball to throw out
+lv_obj_t * sortMenu;
 
 /**
  * The LVGL objects used in the debug menu screen
@@ -122,9 +132,17 @@ lv_obj_t * debugSelectBtnm;
  */ 
 lv_obj_t * debugData1;
 lv_obj_t * debugData2;
+//A button to start or stop recording driver control for the Replay autonomous
+lv_obj_t * recordBtn;
+//A button to simulate every autonomous routine and report how long each takes
+lv_obj_t * analyzeBtn;
+//A button to run the benchmarks
+lv_obj_t * benchmarkBtn;
+lv_obj_t * calibrateBtn;
 
 void GUI::initialize()
 {
+    PROFILE_SCOPE("GUI::initialize");
     //Initializing the screens
     scrMain = createScreen();
     scrAuton = createScreen();
@@ -202,6 +220,22 @@ void GUI::initialize()
     //Initializing the label indicating the autonomous selected
     curAutonLbl = createLabel(scrAuton, "Auton", LV_ALIGN_IN_TOP_LEFT, 10, 10);
 
+    //Initializing the button to run the selected autonomous, and the label showing its progress
+    autonRunBtn = createButton(scrAuton, LV_BTN_ACTION_CLICK, runAuton, "Run", LV_ALIGN_IN_BOTTOM_RIGHT, -10, -10, 125, 35);
+    lv_btn_set_style(autonRunBtn, LV_BTN_STATE_REL, &defaultStyle);
+    lv_btn_set_style(autonRunBtn, LV_BTN_STATE_PR, &buttonStylePr);
+    autonProgressLbl = createLabel(scrAuton, "", LV_ALIGN_IN_BOTTOM_LEFT, 130, -20);
+    //The progress label is refreshed by an LVGL task, so it is updated from the GUI task like everything else
+    lv_task_create(updateAutonProgress, 100, LV_TASK_PRIO_LOW, NULL);
+
+    //Initializing the color sorting button matrix, with "No Sort" selected to start
+    sortMenu = createButtonMatrix(scrAuton, sortMap, updateRejectColor, LV_ALIGN_IN_BOTTOM_LEFT, 20, -10, 100, 80);
+    lv_btnm_set_style(sortMenu, LV_BTNM_STYLE_BTN_REL, &defaultStyle);
+    lv_btnm_set_style(sortMenu, LV_BTNM_STYLE_BG, &buttonMatrixStyle);
+    lv_btnm_set_style(sortMenu, LV_BTNM_STYLE_BTN_PR, &buttonStylePr);
+    lv_btnm_set_style(sortMenu, LV_BTNM_STYLE_BTN_TGL_REL, &buttonStylePr);
+    lv_btnm_set_toggle(sortMenu, true, 2);
+
     //Initializing the Debug Menu
     debugSelectBtnm = createButtonMatrix(scrDebug, debugMap, updateTelemetryData, LV_ALIGN_IN_TOP_LEFT, 10, 45, 460, 50);
     lv_btnm_set_style(debugSelectBtnm, LV_BTNM_STYLE_BTN_REL, &defaultStyle);
@@ -210,6 +244,28 @@ void GUI::initialize()
 
     debugData1 = createLabel(scrDebug, "Debug Data", LV_ALIGN_IN_LEFT_MID, 10, -10); 
     debugData2 = createLabel(scrDebug, "Debug Data", LV_ALIGN_IN_LEFT_MID, 10, 55); 
+
+    //Initializing the button to record driver control
+    recordBtn = createButton(scrDebug, LV_BTN_ACTION_CLICK, toggleRecording, "Record", LV_ALIGN_IN_TOP_RIGHT, -10, 10, 125, 30);
+    lv_btn_set_style(recordBtn, LV_BTN_STATE_REL, &defaultStyle);
+    lv_btn_set_style(recordBtn, LV_BTN_STATE_PR, &buttonStylePr);
+
+    //Initializing the button to analyze the autonomous routines
+    analyzeBtn = createButton(scrDebug, LV_BTN_ACTION_CLICK, analyzeAutons, "Analyze", LV_ALIGN_IN_TOP_RIGHT, -145, 10, 125, 30);
+    lv_btn_set_style(analyzeBtn, LV_BTN_STATE_REL, &defaultStyle);
+    lv_btn_set_style(analyzeBtn, LV_BTN_STATE_PR, &buttonStylePr);
+
+    //Initializing the button to run the benchmarks
+    benchmarkBtn = createButton(scrDebug, LV_BTN_ACTION_CLICK, runBenchmarks, "Benchmark", LV_ALIGN_IN_BOTTOM_RIGHT, -10, -10, 125, 30);
+    //Holding the button down compares the move modes instead, as that moves the robot
+    lv_btn_set_action(benchmarkBtn, LV_BTN_ACTION_LONG_PR, compareMoveModes);
+    lv_btn_set_style(benchmarkBtn, LV_BTN_STATE_REL, &defaultStyle);
+    lv_btn_set_style(benchmarkBtn, LV_BTN_STATE_PR, &buttonStylePr);
+
+    //Initializing the button to calibrate the drive geometry
+    calibrateBtn = createButton(scrDebug, LV_BTN_ACTION_CLICK, calibrateDrive, "Calibrate", LV_ALIGN_IN_BOTTOM_RIGHT, -145, -10, 125, 30);
+    lv_btn_set_style(calibrateBtn, LV_BTN_STATE_REL, &defaultStyle);
+    lv_btn_set_style(calibrateBtn, LV_BTN_STATE_PR, &buttonStylePr);
     //Loading the main screen to the brain display
     lv_scr_load(scrMain);
 }
@@ -288,6 +344,7 @@ lv_obj_t * GUI::createScreen()
 }
 
 lv_res_t GUI::updateAutonID(lv_obj_t * btnm, const char * txt){
+    PROFILE_SCOPE("GUI::updateAutonID");
     /**
      * Running the current selected button in the matrix through a
      * series of if-else-if statements to determine which autonomous
@@ -301,6 +358,7 @@ lv_res_t GUI::updateAutonID(lv_obj_t * btnm, const char * txt){
     else if(txt == "Mid to Left") autonID = Auton::midleft;
     else if(txt == "Right") autonID = Auton::right;
     else if(txt == "Mid to Right") autonID = Auton::midright;
+    else if(strcmp(txt, "Replay") == 0) autonID = Auton::replay;
     else autonID = Auton::none;
     //Updating the label for the current selected autonomous
     updateAutonLbl();
@@ -309,6 +367,7 @@ lv_res_t GUI::updateAutonID(lv_obj_t * btnm, const char * txt){
 
 void GUI::updateAutonLbl()
 {
+    PROFILE_SCOPE("GUI::updateAutonLbl");
     /**
      * Using autonID as a switch, the function determines
      * the current autonomous routine selected and sets 
@@ -335,47 +394,157 @@ void GUI::updateAutonLbl()
         case Auton::midright:
             lv_label_set_text(curAutonLbl, "Middle + Right Corner");
             break;
+        case Auton::replay:
+            lv_label_set_text(curAutonLbl, "Replay Recording");
+            break;
         case Auton::none:
             lv_label_set_text(curAutonLbl, "No Auton Selected");
             break;
     }
 }
 
-lv_res_t GUI::updateTelemetryData(lv_obj_t * btnm, const char* txt)
+lv_res_t GUI::updateRejectColor(lv_obj_t * btnm, const char * txt)
 {
+    PROFILE_SCOPE("GUI::updateRejectColor");
+    //Selecting a color tells the ColorSorter to throw out balls of that color
+    if(strcmp(txt, "Red") == 0) sorter.setRejectColor(BallColor::red);
+    else if(strcmp(txt, "Blue") == 0) sorter.setRejectColor(BallColor::blue);
+    else sorter.setRejectColor(BallColor::none);
+    return LV_RES_OK;
+}
 
+lv_res_t GUI::updateTelemetryData(lv_obj_t * btnm, const char* txt)
+{
+    PROFILE_SCOPE("GUI::updateTelemetryData");
+    if(strcmp(txt, "Tasks") == 0) {
+        updateTaskLabels();
+        return LV_RES_OK;
+    }
+    if(strcmp(txt, "Profile") == 0) {
+        updateProfileLabels();
+        return LV_RES_OK;
+    }
     lv_label_set_text(debugData1, "No Data Selected");
     lv_label_set_text(debugData2, "No Data Selected"); 
     return LV_RES_OK;
 }
 
+void GUI::updateTaskLabels()
+{
+    PROFILE_SCOPE("GUI::updateTaskLabels");
+    /**
+     * One line per task with its CPU use and stack use goes in debugData1, and
+     * the heap use goes in debugData2. The task list can be long, so the labels
+     * are moved to fill the screen below the button matrix
+     */
+    TaskMonitor::TaskStats stats[TaskMonitor::maxTasks];
+    int count = TaskMonitor::getTaskStats(stats, TaskMonitor::maxTasks);
+    TextBuffer<512> text;
+    for(int i = 0; i < count; i++) {
+        text.append(stats[i].name);
+        text.append(": ");
+        text.appendFixed(stats[i].cpu, 1);
+        text.append("% CPU, stack ");
+        if(stats[i].stackKnown) text.appendFixed(stats[i].stackUsed / 1024.0, 1);
+        else text.append("?");
+        text.append("/");
+        text.appendFixed(stats[i].stackBytes / 1024.0, 1);
+        text.append(" KB\n");
+    }
+    lv_label_set_text(debugData1, text.c_str());
+    lv_obj_align(debugData1, NULL, LV_ALIGN_IN_TOP_LEFT, 10, 100);
+
+    TaskMonitor::HeapStats heap = TaskMonitor::getHeapStats();
+    text.clear();
+    text.append("Heap: ");
+    text.appendFixed(heap.heapUsed / 1024.0, 1);
+    text.append("/");
+    text.appendFixed(heap.heapTotal / 1024.0, 1);
+    text.append(" KB  LVGL: ");
+    if(heap.lvglTotal == 0) text.append("kernel heap");
+    else {
+        text.appendFixed(heap.lvglUsed / 1024.0, 1);
+        text.append("/");
+        text.appendFixed(heap.lvglTotal / 1024.0, 1);
+        text.append(" KB");
+    }
+    //The control task's timing, the pose, and the slip and jam counts, all read from what was last published
+    Tasks::ControlStats control = Tasks::getControlStats();
+    text.append("\nControl jitter: ");
+    text.appendInt(control.lastJitterUs);
+    text.append(" us (max ");
+    text.appendInt(control.maxJitterUs);
+    text.append(")  Pose: ");
+    Pose pose = odom.getPose();
+    text.appendFixed(pose.x, 1);
+    text.append(", ");
+    text.appendFixed(pose.y, 1);
+    text.append(", ");
+    text.appendFixed(pose.theta, 1);
+    text.append("  Slips: ");
+    text.appendInt(drive.getSlipEvents());
+    text.append("  Jams: ");
+    text.appendInt(intake.getJamDetector().getStats().jams);
+    text.append("/");
+    text.appendInt(conveyor.getJamDetector().getStats().jams);
+    lv_label_set_text(debugData2, text.c_str());
+    lv_obj_align(debugData2, NULL, LV_ALIGN_IN_BOTTOM_LEFT, 10, -10);
+}
+
+void GUI::updateProfileLabels()
+{
+    /**
+     * The full summary, with histograms, is printed to the terminal. The
+     * screen only has room for the mean and maximum time of each probe, so
+     * the probes that have run are listed until the label is full
+     */
+    Profiler::print();
+    TextBuffer<512> text;
+    if(!Profiler::isEnabled()) text.append("Probes not compiled in (make PROFILE=1)");
+    for(Profiler::Probe * p = Profiler::first(); p != NULL && !text.overflowed(); p = p->next) {
+        uint32_t count = p->count;
+        if(count == 0) continue;
+        text.append(p->name);
+        text.append(": ");
+        text.appendFixed((double)p->totalUs.load() / count, 1);
+        text.append(" us mean, ");
+        text.appendInt(p->maxUs);
+        text.append(" us max\n");
+    }
+    lv_label_set_text(debugData1, text.c_str());
+    lv_obj_align(debugData1, NULL, LV_ALIGN_IN_TOP_LEFT, 10, 100);
+    lv_label_set_text(debugData2, "");
+}
+
+/**
+ * The buffer telemetry label text is built in. It is only used by the GUI task,
+ * and LVGL copies the text when it is set, so one buffer is shared by every label
+ */
+static TextBuffer<256> telemetryText;
+
 void GUI::updateTelemetryLabel(lv_obj_t * label, Telemetry t)
 {   
+    PROFILE_SCOPE("GUI::updateTelemetryLabel");
     /**
-     * Creating char arrays to hold the rounded data for each telemetry value
-     * I do this to cut the size of the data, rather than
-     * printing every character, which includes a lot of zeros at the end
-     * The arrays are 30 characters in order to include the labels for each data value
+     * Each value is written with 2 decimal places, which cuts out the long
+     * run of digits printing the full double would give. TextBuffer does this
+     * with integer math, which is much faster than snprintf's %f
      */ 
-    char pos[30]; 
-    char targPos[30]; 
-    char velo[30]; 
-    char targVelo[30]; 
-    char temp[30]; 
-    char torque[30]; 
-    //Creating a char[] to write the output to
-    char output[256];
-    //Printing the Telemetry values to their respective arrays
-    snprintf(pos, 30, "Position: %f", t.pos);
-    snprintf(targPos, 30, "Target Position: %f", t.targetPos);
-    snprintf(velo, 30, "Velocity: %f", t.velo);
-    snprintf(targVelo, 30, "Target Velocity%f", t.targetVelo);
-    snprintf(temp, 30, "Temperature: %f", t.temp);
-    snprintf(torque, 30, "Torque %f", t.torque);
-    //Printing the shortened telemetry values to the output array
-    snprintf(output, 256, "%s%s\n%s%s\n%s%s", pos, targPos, velo, targVelo, temp, torque);
+    telemetryText.clear();
+    telemetryText.append("Position: ");
+    telemetryText.appendFixed(t.pos);
+    telemetryText.append("  Target Position: ");
+    telemetryText.appendFixed(t.targetPos);
+    telemetryText.append("\nVelocity: ");
+    telemetryText.appendFixed(t.velo);
+    telemetryText.append("  Target Velocity: ");
+    telemetryText.appendFixed(t.targetVelo);
+    telemetryText.append("\nTemperature: ");
+    telemetryText.appendFixed(t.temp);
+    telemetryText.append("  Torque: ");
+    telemetryText.appendFixed(t.torque);
     //Setting the text on the label
-    lv_label_set_text(label, output);
+    lv_label_set_text(label, telemetryText.c_str());
 }
 /**
  * LVGL doesn't allow functions with parameters to be a callback function for a
@@ -384,24 +553,298 @@ void GUI::updateTelemetryLabel(lv_obj_t * label, Telemetry t)
  */ 
 lv_res_t GUI::goToAuton(lv_obj_t * btn)
 {
+    PROFILE_SCOPE("GUI::goToAuton");
     lv_scr_load(scrAuton);
     return LV_RES_OK;
 }
 
 lv_res_t GUI::goToMain(lv_obj_t * btn)
 {
+    PROFILE_SCOPE("GUI::goToMain");
     lv_scr_load(scrMain);
     return LV_RES_OK;
 }
 
 lv_res_t GUI::goToDebug(lv_obj_t * btn)
 {
+    PROFILE_SCOPE("GUI::goToDebug");
     lv_scr_load(scrDebug);
     return LV_RES_OK;
 }
 
+lv_res_t GUI::toggleRecording(lv_obj_t * btn)
+{
+    PROFILE_SCOPE("GUI::toggleRecording");
+    /**
+     * The first press arms the recorder, which starts recording on the next
+     * driver control tick and saves itself after 15 seconds. Pressing again
+     * before then stops and saves the recording early
+     */
+    lv_obj_t * label = lv_obj_get_child(btn, NULL);
+    if(recorder.isArmed()) {
+        recorder.disarm();
+        lv_label_set_text(label, "Record");
+    }
+    else {
+        recorder.arm();
+        lv_label_set_text(label, "Stop Recording");
+    }
+    return LV_RES_OK;
+}
+
+/**
+ * The state of an autonomous started from the GUI. The routine runs in its own
+ * task, which writes these, and updateAutonProgress reads them from the GUI task.
+ * The analysis and the benchmarks use the CommandPool, the Timeline and the
+ * motors too, so they aren't run while a routine is
+ */
+static Auton guiAutonID = Auton::none;
+static std::atomic<bool> guiAutonRunning(false);
+static std::atomic<bool> guiAutonCancelled(false);
+static std::atomic<uint32_t> guiAutonExpected(0);
+static std::atomic<uint32_t> guiAutonStart(0);
+static std::atomic<uint32_t> guiAutonTime(0);
+//The name and stack size of the GUI's autonomous task, for task_create and the TaskMonitor
+static const char * guiAutonName = "GUI Autonomous";
+static constexpr uint32_t guiAutonStack = TASK_STACK_DEPTH_DEFAULT;
+//Whether the benchmarks are running in their own task, so they can't be started twice at once
+static std::atomic<bool> benchmarkRunning(false);
+
+lv_res_t GUI::analyzeAutons(lv_obj_t * btn)
+{
+    PROFILE_SCOPE("GUI::analyzeAutons");
+    if(guiAutonRunning) {
+        lv_label_set_text(debugData2, "Stop the autonomous first");
+        return LV_RES_OK;
+    }
+    //While the routine is being armed (see PreArm.hpp) it has the CommandPool, so it is tried again later
+    if(PreArm::isArming() || !AutonAnalyzer::tryLock()) {
+        lv_label_set_text(debugData2, "Arming, try again");
+        return LV_RES_OK;
+    }
+    /**
+     * The full report goes to the terminal and the microSD card, so only
+     * the longest routine's time is shown on the screen
+     */
+    uint32_t longest = AutonAnalyzer::analyzeAll();
+    AutonAnalyzer::unlock();
+    TextBuffer<48> text;
+    text.append("Longest auton: ");
+    text.appendInt(longest);
+    text.append(" ms");
+    lv_label_set_text(debugData2, text.c_str());
+    return LV_RES_OK;
+}
+
+static void benchmarkFn(void * param)
+{
+    //Both print their full results, so only the number of failures is added here
+    int failed = Benchmark::runAll();
+    Benchmark::compareParticleCounts();
+    printf("\n[benchmarks] %d failed\n", failed);
+    benchmarkRunning = false;
+}
+
+lv_res_t GUI::runBenchmarks(lv_obj_t * btn)
+{
+    PROFILE_SCOPE("GUI::runBenchmarks");
+    if(guiAutonRunning) {
+        lv_label_set_text(debugData2, "Stop the autonomous first");
+        return LV_RES_OK;
+    }
+    /**
+     * The benchmarks and the Localizer's particle count comparison take a few
+     * seconds, so they run in their own task, like the move mode comparison,
+     * and the GUI keeps updating. The results go to the terminal
+     */
+    if(benchmarkRunning) return LV_RES_OK;
+    benchmarkRunning = true;
+    pros::c::task_create(benchmarkFn, NULL, TASK_PRIORITY_DEFAULT,
+                         TASK_STACK_DEPTH_DEFAULT, "Benchmarks");
+    lv_label_set_text(debugData2, "Running benchmarks, see terminal");
+    return LV_RES_OK;
+}
+
+/**
+ * The step the drive calibration is on: 0 before it starts, 1 while the robot is
+ * being pushed, and 2 while it spins. Only the calibration task changes it from
+ * 2 back to 0, once the turns are done
+ */
+static std::atomic<int> calibrateStep(0);
+
+//Whether the move mode comparison is running, so it can't be started twice at once
+static std::atomic<bool> moveCompareRunning(false);
+
+static void moveCompareFn(void * param)
+{
+    //Driver control is paused so the control task doesn't fight the moves, and handed back before the robot is
+    bool wasDriverControl = Tasks::isDriverControl();
+    Tasks::setDriverControl(false);
+    Benchmark::compareMoveModes();
+    Tasks::setDriverControl(wasDriverControl);
+    Tasks::releaseRobot();
+    moveCompareRunning = false;
+}
+
+lv_res_t GUI::compareMoveModes(lv_obj_t * btn)
+{
+    /**
+     * The moves take a few seconds, so they run in their own task and the
+     * results go to the terminal. The robot is claimed here (see Tasks.hpp),
+     * so the comparison doesn't start while an autonomous or the drive
+     * calibration is driving, and neither starts while it runs
+     */
+    if(moveCompareRunning) return LV_RES_OK;
+    if(calibrateStep != 0 || !Tasks::tryClaimRobot()) {
+        lv_label_set_text(debugData2, "The robot is busy");
+        return LV_RES_OK;
+    }
+    moveCompareRunning = true;
+    pros::c::task_create(moveCompareFn, NULL, TASK_PRIORITY_DEFAULT,
+                         TASK_STACK_DEPTH_DEFAULT, "Move Comparison");
+    lv_label_set_text(debugData2, "Comparing move modes, see terminal");
+    return LV_RES_OK;
+}
+
+static void calibrateTurnFn(void * param)
+{
+    /**
+     * The result goes to the terminal, as the label may be showing something
+     * else by the time the turns are done
+     */
+    double width = Calibration::calibrateTurn();
+    if(width > 0) printf("\n[calibration] wheel diameter %.3f in, track width %.3f in\n",
+                         drive.getWheelDiameter(), width);
+    else printf("\n[calibration] track width not measured, is the IMU calibrated?\n");
+    Tasks::releaseRobot();
+    calibrateStep = 0;
+}
+
+lv_res_t GUI::calibrateDrive(lv_obj_t * btn)
+{
+    PROFILE_SCOPE("GUI::calibrateDrive");
+    /**
+     * The first press starts the straight measurement, and the second finishes
+     * it and spins the robot for the track width in its own task, as that takes
+     * several seconds. Pressing while it spins does nothing. The robot is
+     * claimed (see Tasks.hpp) for the spin, so it doesn't start while an
+     * autonomous or the move mode comparison is driving, and neither starts
+     * while it spins. Neither starts while the robot is being pushed either
+     */
+    TextBuffer<96> text;
+    if(calibrateStep == 0 && Tasks::isRobotClaimed()) text.append("The robot is busy");
+    else if(calibrateStep == 1 && !Tasks::tryClaimRobot()) {
+        text.append("The robot is busy, press Calibrate again once it is free");
+    }
+    else if(calibrateStep == 0) {
+        Calibration::startStraight();
+        calibrateStep = 1;
+        text.append("Push the robot ");
+        text.appendInt(Calibration::straightDistance);
+        text.append(" in straight forward, then press Calibrate");
+    }
+    else if(calibrateStep == 1) {
+        double diameter = Calibration::finishStraight();
+        if(diameter <= 0) {
+            Tasks::releaseRobot();
+            calibrateStep = 0;
+            text.append("Robot wasn't pushed, calibration cancelled");
+        }
+        else {
+            calibrateStep = 2;
+            text.append("Wheel diameter ");
+            text.appendFixed(diameter, 3);
+            text.append(" in, stand clear: spinning");
+            pros::c::task_create(calibrateTurnFn, NULL, TASK_PRIORITY_DEFAULT,
+                                 TASK_STACK_DEPTH_DEFAULT, "Calibration");
+        }
+    }
+    else return LV_RES_OK;
+    lv_label_set_text(debugData2, text.c_str());
+    return LV_RES_OK;
+}
+
+static void guiAutonFn(void * param)
+{
+    //Registered first, as the TaskMonitor finds the task's stack from where add() is called
+    int monitorId = TaskMonitor::add(guiAutonName, guiAutonStack);
+    /**
+     * The routine is simulated first to find how long it should take, so the
+     * progress can be shown as a fraction of that. A recording can't be
+     * simulated, so only the elapsed time is shown for it. The scheduler and
+     * the recorder forget any cancel made before they start, so a routine
+     * cancelled while the simulation ran isn't started at all
+     */
+    if(guiAutonID == Auton::replay) guiAutonExpected = 0;
+    else {
+        AutonAnalyzer::lock();
+        guiAutonExpected = AutonAnalyzer::simulate(guiAutonID);
+        AutonAnalyzer::unlock();
+    }
+    guiAutonStart = pros::c::millis();
+    if(!guiAutonCancelled) runAutonomous(monitorId, false);
+    guiAutonTime = pros::c::millis() - guiAutonStart;
+    guiAutonRunning = false;
+}
+
 lv_res_t GUI::runAuton(lv_obj_t * btn)
 {
-    autonomous();
+    PROFILE_SCOPE("GUI::runAuton");
+    /**
+     * The routine runs in its own task, so the GUI keeps updating while it runs.
+     * Pressing the button again while it runs cancels it: the scheduler (or the
+     * recorder, for a replay) checks for a cancel each tick, interrupts whatever
+     * is running (which stops the motors) and returns. Only the one running the
+     * routine is asked
+     */
+    if(guiAutonRunning) {
+        guiAutonCancelled = true;
+        if(guiAutonID == Auton::replay) recorder.stopReplay();
+        else scheduler.requestCancel();
+        return LV_RES_OK;
+    }
+    //Something else is driving the robot, like the move mode comparison or a competition autonomous, or it is being pushed for the calibration
+    if(Tasks::isRobotClaimed() || calibrateStep != 0) {
+        lv_label_set_text(autonProgressLbl, "The robot is busy");
+        return LV_RES_OK;
+    }
+    guiAutonID = autonID.load();
+    guiAutonRunning = true;
+    guiAutonCancelled = false;
+    pros::c::task_create(guiAutonFn, NULL, TASK_PRIORITY_DEFAULT, guiAutonStack, guiAutonName);
     return LV_RES_OK;
+}
+
+void GUI::updateAutonProgress(void * param)
+{
+    /**
+     * While the routine runs, the label shows the action running now and the
+     * time so far out of the expected time. Once it ends, it shows how long it
+     * took. The button's label only changes when the routine starts or stops
+     */
+    static bool wasRunning = false;
+    bool running = guiAutonRunning;
+    TextBuffer<96> text;
+    if(running) {
+        const char * action = Timeline::currentAction();
+        text.append(guiAutonCancelled ? "Stopping" : action != NULL ? action : "Running");
+        text.append(": ");
+        text.appendFixed((pros::c::millis() - guiAutonStart) / 1000.0, 1);
+        if(guiAutonExpected > 0) {
+            text.append(" / ");
+            text.appendFixed(guiAutonExpected / 1000.0, 1);
+        }
+        text.append(" s");
+        lv_label_set_text(autonProgressLbl, text.c_str());
+    }
+    else if(wasRunning) {
+        text.append(guiAutonCancelled ? "Stopped after " : "Finished in ");
+        text.appendFixed(guiAutonTime / 1000.0, 1);
+        text.append(" s");
+        lv_label_set_text(autonProgressLbl, text.c_str());
+    }
+    if(running != wasRunning) {
+        lv_label_set_text(lv_obj_get_child(autonRunBtn, NULL), running ? "Stop" : "Run");
+        wasRunning = running;
+    }
 }
\ No newline at end of file
@@ -7,7 +7,8 @@
  */ 
 
 Intake::Intake(std::initializer_list<int> ports, std::initializer_list<bool> revs, 
-               pros::motor_gearset_e_t gearset, pros::controller_digital_e_t inBtn, pros::controller_digital_e_t outBtn) {
+               pros::motor_gearset_e_t gearset, pros::controller_digital_e_t inBtn, pros::controller_digital_e_t outBtn)
+    : jam(ports) {
     motorPorts = ports;
     std::vector<bool> motorRevs = revs;
     for(int i = 0; i < motorPorts.size(); i++) {
@@ -19,27 +20,48 @@ Intake::Intake(std::initializer_list<int> ports, std::initializer_list<bool> rev
 }
 
 void Intake::driver(pros::controller_id_e_t controller) {
-    if(pros::c::controller_get_digital(controller, inButton)) in();
-    else if(pros::c::controller_get_digital(controller, outButton)) out();
-    else stop();   
+    driver(ControllerState::read(controller));
+}
+
+void Intake::driver(const ControllerState & input) {
+    PROFILE_SCOPE("Intake::driver");
+    MotorOutputs out = {};
+    plan(input, out);
+    setPower(out.intake);
+}
+
+void Intake::plan(const ControllerState & input, MotorOutputs & out) const {
+    if(input.getDigital(inButton)) out.intake = 127;
+    else if(input.getDigital(outButton)) out.intake = -127;
+    else out.intake = 0;
+    out.intakeSet = true;
+}
+
+void Intake::setPower(int power) {
+    jam.setPower(power);
 }
 
 void Intake::in() {
-    for(int p : motorPorts) {
-        pros::c::motor_move(p, 127);
-    }
+    PROFILE_SCOPE("Intake::in");
+    jam.setPower(127);
 }
 
 void Intake::out() {
-    for(int p : motorPorts) {
-        pros::c::motor_move(p, -127);
-    }
+    PROFILE_SCOPE("Intake::out");
+    jam.setPower(-127);
 }
 
 void Intake::stop() {
-    for(int p : motorPorts) {
-        pros::c::motor_move(p, 0);
-    }
+    PROFILE_SCOPE("Intake::stop");
+    jam.setPower(0);
+}
+
+std::vector<int> Intake::getMotorPorts() {
+    return motorPorts;
+}
+
+JamDetector & Intake::getJamDetector() {
+    return jam;
 }
 /**
 void Intake::updateLeftTelemetry()
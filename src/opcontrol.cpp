@@ -14,11 +14,27 @@
  * task, not resume it from where it left off.
  */
 void opcontrol() {
-    while(true)
-    {
-        drive.driver(CONTROLLER_MASTER);
-        intake.driver(CONTROLLER_MASTER);
-        conveyor.driver(CONTROLLER_MASTER);
-        pros::delay(20);
-    }
+    //PROS ends the disabled and autonomous tasks before starting this one, so whatever they left is cleaned up first
+    recoverAutonomous();
+    //Taking the intake and conveyor back from the indexer, if autonomous left it running
+    indexer.stop();
+    /**
+     * Driver control runs in the control task (see Tasks.hpp) rather than here,
+     * so its timing doesn't depend on the priority PROS gives this task. The
+     * control task reads the controller once per tick at a fixed period, so a
+     * recording made there replays with the same timing. This task has nothing
+     * left to do, so it returns
+     */
+    Tasks::setDriverControl(true);
+}
+
+void driverTick(const ControllerState & input) {
+    /**
+     * A tick from a recording uses the latest readings of everything else,
+     * with the recorded controller in place of the real one
+     */
+    Tasks::SensorFrame frame = Tasks::getSensorFrame();
+    frame.controller = input;
+    frame.indexer = indexer.getState();
+    Pipeline::tick(frame);
 }
\ No newline at end of file
@@ -0,0 +1,34 @@
+#!/usr/bin/env python3
+"""
+Prints a driver control recording made by the Recorder class (see
+include/lib/Recorder.hpp) as CSV, one row per tick, so a recording can be
+checked or plotted on a computer before it is run on the robot.
+
+Usage: replay_dump.py replay.bin > replay.csv
+"""
+import struct
+import sys
+
+BUTTONS = ["L1", "L2", "R1", "R2", "UP", "DOWN", "LEFT", "RIGHT", "X", "B", "Y", "A"]
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__.strip())
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+    if len(data) < 12 or data[:4] != b"RPL1":
+        sys.exit("not a recording file")
+    period, count = struct.unpack_from("<II", data, 4)
+    print("time_ms,left_x,left_y,right_x,right_y," + ",".join(BUTTONS))
+    for i in range(count):
+        offset = 12 + 6 * i
+        if offset + 6 > len(data):
+            sys.exit("recording is truncated after %d of %d frames" % (i, count))
+        lx, ly, rx, ry, digital = struct.unpack_from("<bbbbH", data, offset)
+        buttons = [str((digital >> b) & 1) for b in range(len(BUTTONS))]
+        print("%d,%d,%d,%d,%d,%s" % (i * period, lx, ly, rx, ry, ",".join(buttons)))
+
+
+if __name__ == "__main__":
+    main()